@@ -1,8 +1,9 @@
 #include <AStar.hpp>
-#include <RobotWorld.hpp>
-#include <Shape2DUtils.hpp>
-#include <Wall.hpp>
+#include <AllocationCounter.hpp>
+#include <OccupancyGrid.hpp>
+#include <PathCache.hpp>
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <iterator>
 #include <sstream>
@@ -11,89 +12,311 @@
 
 namespace PathAlgorithm
 {
+	/* static */ const std::size_t OpenSet::NoPosition;
+	/* static */ const unsigned long AStar::DefaultSnapshotInterval;
 	/**
 	 *
 	 */
-	double ActualCost(	const Vertex& aStart,
-						const Vertex& aGoal)
+	OpenSet::OpenSet() :
+						slotKeys( 16),
+						slotPositions( 16, NoPosition),
+						slotMask( 15)
 	{
-		return std::sqrt( (aStart.x - aGoal.x) * (aStart.x - aGoal.x) + (aStart.y - aGoal.y) * (aStart.y - aGoal.y));
 	}
 	/**
 	 *
 	 */
-	double HeuristicCost(	const Vertex& aStart,
-							const Vertex& aGoal)
+	void OpenSet::clear()
 	{
-		return std::sqrt( (aStart.x - aGoal.x) * (aStart.x - aGoal.x) + (aStart.y - aGoal.y) * (aStart.y - aGoal.y));
+		heap.clear();
+		std::fill( slotPositions.begin(), slotPositions.end(), NoPosition);
 	}
 	/**
 	 *
 	 */
-	Path ConstructPath(	VertexMap& aPredecessorMap,
-						const Vertex& aCurrentNode)
+	void OpenSet::reserve( std::size_t aSize)
 	{
-		VertexMap::iterator i = aPredecessorMap.find( aCurrentNode);
-		if (i != aPredecessorMap.end())
+		heap.reserve( aSize);
+		if (2 * aSize > slotPositions.size())
 		{
-			Path path = ConstructPath( aPredecessorMap, (*i).second);
-			path.push_back( aCurrentNode);
-			return path;
+			rehash( aSize);
+		}
+	}
+	/**
+	 *
+	 */
+	std::size_t OpenSet::getAllocatedBytes() const
+	{
+		return heap.capacity() * sizeof( Vertex) + slotKeys.capacity() * sizeof( unsigned long long) + slotPositions.capacity() * sizeof( std::size_t);
+	}
+	/**
+	 *
+	 */
+	void OpenSet::pop()
+	{
+		eraseAt( 0);
+	}
+	/**
+	 *
+	 */
+	void OpenSet::push( const Vertex& aVertex)
+	{
+		if (update( aVertex))
+		{
+			return;
+		}
+		if (2 * (heap.size() + 1) > slotPositions.size())
+		{
+			rehash( heap.size() + 1);
+		}
+		heap.push_back( aVertex);
+		setPosition( key( aVertex), heap.size() - 1);
+		siftUp( heap.size() - 1);
+	}
+	/**
+	 *
+	 */
+	bool OpenSet::update( const Vertex& aVertex)
+	{
+		std::size_t position = positionOf( key( aVertex));
+		if (position == NoPosition)
+		{
+			return false;
+		}
+		bool decreased = aVertex.lessCost( heap[position]);
+		heap[position] = aVertex;
+		if (decreased)
+		{
+			siftUp( position);
 		} else
 		{
-			Path path;
-			path.push_back( aCurrentNode);
-			return path;
+			siftDown( position);
 		}
+		return true;
 	}
 	/**
 	 *
 	 */
-	std::vector< Vertex > GetNeighbours(	const Vertex& aVertex,
-											int aFreeRadius /*= 1*/)
-				{
-		static int xOffset[] = { 0, 1, 1, 1, 0, -1, -1, -1 };
-		static int yOffset[] = { 1, 1, 0, -1, -1, -1, 0, 1 };
-
-		const std::vector< Model::WallPtr >& walls = Model::RobotWorld::getRobotWorld().getWalls();
-		std::vector< Vertex > neighbours;
-
-		for (int i = 0; i < 8; ++i)
+	OpenSet::const_iterator OpenSet::find( const Vertex& aVertex) const
+	{
+		std::size_t position = positionOf( key( aVertex));
+		if (position == NoPosition)
 		{
-			bool addToNeigbours = true;
+			return heap.end();
+		}
+		return heap.begin() + static_cast< std::ptrdiff_t >(position);
+	}
+	/**
+	 *
+	 */
+	void OpenSet::erase( const_iterator i)
+	{
+		if (i != heap.end())
+		{
+			eraseAt( static_cast< std::size_t >(i - heap.begin()));
+		}
+	}
+	/**
+	 *
+	 */
+	bool OpenSet::erase( const Vertex& aVertex)
+	{
+		const_iterator i = find( aVertex);
+		if (i == heap.end())
+		{
+			return false;
+		}
+		erase( i);
+		return true;
+	}
+	/**
+	 *
+	 */
+	void OpenSet::eraseAt( std::size_t aPosition)
+	{
+		removePosition( key( heap[aPosition]));
 
-			Vertex vertex( aVertex.x + xOffset[i], aVertex.y + yOffset[i]);
-			for (Model::WallPtr wall : walls)
+		std::size_t last = heap.size() - 1;
+		if (aPosition != last)
+		{
+			Vertex moved = heap[last];
+			heap.pop_back();
+			place( aPosition, moved);
+			// the moved vertex may have to go either way
+			siftUp( aPosition);
+			siftDown( positionOf( key( moved)));
+		} else
+		{
+			heap.pop_back();
+		}
+	}
+	/**
+	 *
+	 */
+	void OpenSet::siftUp( std::size_t aPosition)
+	{
+		Vertex vertex = heap[aPosition];
+		while (aPosition > 0)
+		{
+			std::size_t parent = (aPosition - 1) / 2;
+			if (!vertex.lessCost( heap[parent]))
 			{
-				if (Utils::Shape2DUtils::isOnLine( wall->getPoint1(), wall->getPoint2(), vertex.asPoint(), aFreeRadius))
-				{
-					addToNeigbours = false;
-					break;
-				}
+				break;
+			}
+			place( aPosition, heap[parent]);
+			aPosition = parent;
+		}
+		place( aPosition, vertex);
+	}
+	/**
+	 *
+	 */
+	void OpenSet::siftDown( std::size_t aPosition)
+	{
+		Vertex vertex = heap[aPosition];
+		std::size_t size = heap.size();
+		for (;;)
+		{
+			std::size_t child = 2 * aPosition + 1;
+			if (child >= size)
+			{
+				break;
+			}
+			if (child + 1 < size && heap[child + 1].lessCost( heap[child]))
+			{
+				++child;
 			}
-			if (addToNeigbours == true)
+			if (!heap[child].lessCost( vertex))
 			{
-				neighbours.push_back( vertex);
+				break;
 			}
+			place( aPosition, heap[child]);
+			aPosition = child;
 		}
-		return neighbours;
-				}
+		place( aPosition, vertex);
+	}
 	/**
 	 *
 	 */
-	std::vector< Edge > GetNeighbourConnections(	const Vertex& aVertex,
-													int aFreeRadius /*= 1*/)
-				{
-		std::vector< Edge > connections;
-
-		const std::vector< Vertex >& neighbours = GetNeighbours( aVertex, aFreeRadius);
-		for (const Vertex& vertex : neighbours)
+	void OpenSet::place( std::size_t aPosition,
+						 const Vertex& aVertex)
+	{
+		heap[aPosition] = aVertex;
+		setPosition( key( aVertex), aPosition);
+	}
+	/**
+	 *
+	 */
+	void OpenSet::removePosition( unsigned long long aKey)
+	{
+		std::size_t slot = slotOf( aKey);
+		if (slotPositions[slot] == NoPosition)
+		{
+			return;
+		}
+		// Shift the following keys of the probe sequence back so no lookup stops too early
+		std::size_t next = slot;
+		for (;;)
+		{
+			next = (next + 1) & slotMask;
+			if (slotPositions[next] == NoPosition)
+			{
+				break;
+			}
+			std::size_t home = homeSlot( slotKeys[next]);
+			bool stays = slot <= next ? (slot < home && home <= next) : (slot < home || home <= next);
+			if (!stays)
+			{
+				slotKeys[slot] = slotKeys[next];
+				slotPositions[slot] = slotPositions[next];
+				slot = next;
+			}
+		}
+		slotPositions[slot] = NoPosition;
+	}
+	/**
+	 *
+	 */
+	void OpenSet::rehash( std::size_t aSize)
+	{
+		std::size_t size = slotPositions.size();
+		while (size < 2 * aSize)
+		{
+			size *= 2;
+		}
+		slotKeys.assign( size, 0);
+		slotPositions.assign( size, NoPosition);
+		slotMask = size - 1;
+		for (std::size_t position = 0; position < heap.size(); ++position)
 		{
-			connections.push_back( Edge( aVertex, vertex));
+			setPosition( key( heap[position]), position);
 		}
+	}
+	/**
+	 *
+	 */
+	int FreeRadius( const Size& aRobotSize)
+	{
+		return static_cast<int>(std::ceil(std::sqrt( (aRobotSize.x / 2.0) * (aRobotSize.x / 2.0) + (aRobotSize.y / 2.0) * (aRobotSize.y / 2.0))));
+	}
+	/**
+	 *
+	 */
+	double ActualCost(	const Vertex& aStart,
+						const Vertex& aGoal)
+	{
+		return std::sqrt( (aStart.x - aGoal.x) * (aStart.x - aGoal.x) + (aStart.y - aGoal.y) * (aStart.y - aGoal.y));
+	}
+	/**
+	 *
+	 */
+	double HeuristicCost(	const Vertex& aStart,
+							const Vertex& aGoal)
+	{
+		return std::sqrt( (aStart.x - aGoal.x) * (aStart.x - aGoal.x) + (aStart.y - aGoal.y) * (aStart.y - aGoal.y));
+	}
+	/**
+	 *
+	 */
+	Size WorldBounds(	const Vertex& aStart,
+						const Vertex& aGoal,
+						const OccupancyGrid& anOccupancyGrid)
+	{
+		return Size( std::max( anOccupancyGrid.getWidth(), std::max( aStart.x, aGoal.x) + 1),
+					 std::max( anOccupancyGrid.getHeight(), std::max( aStart.y, aGoal.y) + 1));
+	}
+	/**
+	 *
+	 */
+	void GetNeighbours(	const Vertex& aVertex,
+						const OccupancyGrid& anOccupancyGrid,
+						Neighbours& aNeighbours)
+	{
+		static const int xOffset[] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+		static const int yOffset[] = { 1, 1, 0, -1, -1, -1, 0, 1 };
 
-		return connections;
-				}
+		OccupancyGrid::countWallChecks( 8);
+		aNeighbours.size = 0;
+		for (int i = 0; i < 8; ++i)
+		{
+			if (anOccupancyGrid.isFree( aVertex.x + xOffset[i], aVertex.y + yOffset[i]))
+			{
+				Neighbour& neighbour = aNeighbours.cells[aNeighbours.size++];
+				neighbour.x = aVertex.x + xOffset[i];
+				neighbour.y = aVertex.y + yOffset[i];
+				neighbour.diagonal = xOffset[i] != 0 && yOffset[i] != 0;
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	AStar::AStar() :
+								expansionCount( 0),
+								snapshotInterval( DefaultSnapshotInterval),
+								closedCount( 0)
+	{
+	}
 	/**
 	 *
 	 */
@@ -104,9 +327,86 @@ namespace PathAlgorithm
 		Vertex start( aStartPoint);
 		Vertex goal( aGoalPoint);
 
-		Path path = AStar::search( start, goal, aRobotSize);
+		expansionCount = 0;
+		std::atomic_store( &snapshot, SearchSnapshotPtr());
+
+		stats = SearchStats();
+		closedCount = 0;
+		unsigned long wallCheckCount = OccupancyGrid::getWallCheckCount();
+		std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+
+		// The revision of the walls the route is found for
+		OccupancyGridPtr occupancyGrid = OccupancyGrid::getOccupancyGrid( FreeRadius( aRobotSize));
+		std::chrono::steady_clock::time_point gridReady = std::chrono::steady_clock::now();
+		stats.gridTime = gridReady - begin;
+
+		Path path;
+		stats.cacheHit = isCacheable() && PathCache::getPathCache().find( start, goal, *occupancyGrid, path);
+		std::chrono::steady_clock::time_point cacheChecked = std::chrono::steady_clock::now();
+		stats.cacheTime = cacheChecked - gridReady;
+		if (!stats.cacheHit)
+		{
+			unsigned long allocationCount = AllocationCounter::getAllocationCount();
+			try
+			{
+				path = search( start, goal, aRobotSize);
+			}
+			catch (const SearchCancelled&)
+			{
+				// Measured all the same, the cost of the searches that were of no use counts too
+				stats.cancelled = true;
+			}
+			stats.allocationCount = AllocationCounter::getAllocationCount() - allocationCount;
+			std::chrono::steady_clock::time_point found = std::chrono::steady_clock::now();
+			stats.searchTime = found - cacheChecked;
+			if (isCacheable() && !stats.cancelled)
+			{
+				PathCache::getPathCache().insert( start, goal, *occupancyGrid, path);
+				stats.cacheTime += std::chrono::steady_clock::now() - found;
+			}
+		}
+
+		stats.expandedCount = expansionCount;
+		stats.wallCheckCount = OccupancyGrid::getWallCheckCount() - wallCheckCount;
+		stats.allocatedBytes = getAllocatedBytes();
+		if (stats.cancelled)
+		{
+			throw SearchCancelled();
+		}
 		return path;
 	}
+	/**
+	 *
+	 */
+	Path AStar::search(	const Point& aStartPoint,
+						const Point& aGoalPoint,
+						const Size& aRobotSize,
+						SearchStats& aSearchStats)
+	{
+		try
+		{
+			Path path = search( aStartPoint, aGoalPoint, aRobotSize);
+			aSearchStats = stats;
+			return path;
+		}
+		catch (const SearchCancelled&)
+		{
+			aSearchStats = stats;
+			throw;
+		}
+	}
+	/**
+	 *
+	 */
+	Path AStar::search(	const Point& aStartPoint,
+						const Point& aGoalPoint,
+						const Size& aRobotSize,
+						const OccupancyGridPtr& anOccupancyGrid,
+						SearchStats& aSearchStats)
+	{
+		OccupancyGrid::Pin pin( anOccupancyGrid);
+		return search( aStartPoint, aGoalPoint, aRobotSize, aSearchStats);
+	}
 	/**
 	 *
 	 */
@@ -115,163 +415,114 @@ namespace PathAlgorithm
 						const Size& aRobotSize)
 	{
 		getOS().clear();
-		getCS().clear();
-		getPM().clear();
 
-		int radius = static_cast<int>(std::ceil(std::sqrt( (aRobotSize.x / 2.0) * (aRobotSize.x / 2.0) + (aRobotSize.y / 2.0) * (aRobotSize.y / 2.0))));
+		int radius = FreeRadius( aRobotSize);
+
+		// The walls inflated with the radius of the robot
+		OccupancyGridPtr occupancyGrid = OccupancyGrid::getOccupancyGrid( radius);
+
+		Size bounds = WorldBounds( aStart, aGoal, *occupancyGrid);
+		getWS().resize( bounds.x, bounds.y);
+		if (!workspace.contains( aStart.x, aStart.y) || !workspace.contains( aGoal.x, aGoal.y))
+		{
+			std::cerr << "**** No route from " << aStart << " to " << aGoal << ": outside of the world" << std::endl;
+			return Path();
+		}
 
 		aStart.actualCost = 0.0; 													// Cost from aStart along the best known path.
-		aStart.heuristicCost = aStart.actualCost + HeuristicCost( aStart, aGoal);	// Estimated total cost from aStart to aGoal through y.
+		aStart.heuristicCost = aStart.actualCost + estimateCost( aStart, aGoal);	// Estimated total cost from aStart to aGoal through y.
 
+		workspace.visit( workspace.indexOf( aStart.x, aStart.y), aStart.actualCost, SearchWorkspace::NoParent);
 		addToOpenSet(aStart);
 
-		//		long long begin = std::clock();
-
 		while (!openSet.empty())
 		{
-			Vertex current = *openSet.begin();
+			Vertex current = openSet.top();
 
 			if (current.equalPoint( aGoal))
 			{
-				return ConstructPath( predecessorMap, current);
+				return workspace.constructPath( workspace.indexOf( current.x, current.y));
 			} else
 			{
 				addToClosedSet( current);
 				removeFirstFromOpenSet();
 
-				const std::vector< Edge >& connections = GetNeighbourConnections( current, radius);
-				for (const Edge& connection : connections)
+				unsigned int currentIndex = workspace.indexOf( current.x, current.y);
+				publishProgress( currentIndex);
+
+				Neighbours neighbours;
+				GetNeighbours( current, *occupancyGrid, neighbours);
+				for (const Neighbour& candidate : neighbours)
 				{
-					Vertex neighbour = connection.otherSide( current);
+					if (!workspace.contains( candidate.x, candidate.y))
+					{
+						continue;
+					}
+					unsigned int neighbourIndex = workspace.indexOf( candidate.x, candidate.y);
 
-					// The new costs
-					double calculatedActualNeighbourCost = current.actualCost + ActualCost( current, neighbour);
-					double totalHeuristicCostNeighbour = calculatedActualNeighbourCost + HeuristicCost( neighbour, aGoal);
+					// The new cost, a step is either straight or diagonal
+					double calculatedActualNeighbourCost = current.actualCost + (candidate.diagonal ? DiagonalStepCost : 1.0);
 
-					OpenSet::iterator openVertex = findInOpenSet( neighbour);
-					if (openVertex != openSet.end())
+					// The neighbour is either in the openSet or in the closedSet if it is visited,
+					// in both cases we may have found a shorter via-route
+					if (workspace.isVisited( neighbourIndex) && workspace.getActualCost( neighbourIndex) <= calculatedActualNeighbourCost)
 					{
-						// if neighbour is in the openSet we may have found a shorter via-route
-						if ((*openVertex).heuristicCost <= totalHeuristicCostNeighbour)
-						{
-							continue;
-						} else
-						{
-							removeFromOpenSet( openVertex);
-						}
+						continue;
 					}
-					ClosedSet::iterator closedVertex = findInClosedSet( neighbour);
-					if (closedVertex != closedSet.end())
+					bool inOpenSet = workspace.isVisited( neighbourIndex) && !workspace.isClosed( neighbourIndex);
+
+					Vertex neighbour( candidate.x, candidate.y);
+					if (workspace.isClosed( neighbourIndex))
 					{
-						// if neighbour is in the closedSet we may have found a shorter via-route
-						if ((*closedVertex).heuristicCost <= totalHeuristicCostNeighbour)
-						{
-							continue;
-						} else
-						{
-							removeFromClosedSet( closedVertex);
-						}
+						removeFromClosedSet( neighbour);
 					}
 
 					neighbour.actualCost = calculatedActualNeighbourCost;
-					neighbour.heuristicCost = totalHeuristicCostNeighbour;
-
-					std::pair< VertexMap::iterator, bool > insertResult1 = predecessorMap.insert( std::make_pair( neighbour, current));
-					if (insertResult1.second != true)
-					{
-						if (!(*insertResult1.first).first.equalPoint( neighbour))
-						{
-							std::ostringstream os;
-							os << "*** (*insertResult1.first).first != neighbour:\n\t\t" << (*insertResult1.first).first << " <- " << (*insertResult1.first).second << "\n\t\t" << neighbour << " <- " << current;
-							throw std::runtime_error(os.str());
-						}
+					neighbour.heuristicCost = calculatedActualNeighbourCost + estimateCost( neighbour, aGoal);
 
-						if ((*insertResult1.first).first.heuristicCost > neighbour.heuristicCost)
-						{
-							predecessorMap.erase( insertResult1.first);
-							std::pair< VertexMap::iterator, bool > insertResult2 = predecessorMap.insert( std::make_pair( neighbour, current));
-							if (insertResult2.second != true)
-							{
-								std::ostringstream os;
-								os << "**** Failed updating neighbour in the predecessorMap:  " << neighbour << " <- " << current << "\n";
-								if (insertResult2.first != predecessorMap.end())
-								{
-									os << "\tcurrent value in the predecessorMap:  " << (*insertResult2.first).first << " <- " << (*insertResult2.first).second;
-								} else
-								{
-									os << "\tinvalid iterator ";
-								}
-								throw std::runtime_error(os.str());
-							} else
-							{
-							}
-						}
-					} else
-					{
-					}
+					workspace.visit( neighbourIndex, calculatedActualNeighbourCost, currentIndex);
 
-					// if neighbour is not in openSet, add it to the openSet
-					// which should always be the case?
-					openVertex = findInOpenSet( neighbour);
-					if (openVertex == openSet.end())
+					if (inOpenSet)
 					{
-						addToOpenSet( neighbour);
+						// decrease-key, the vertex keeps its place in the openSet index
+						updateInOpenSet( neighbour);
 					} else
 					{
-						std::cerr << "**** Failed adding neighbour to the openSet:  " << neighbour << std::endl;
+						addToOpenSet( neighbour);
 					}
-				} //for(Edge connection : connections)
-
-				//			Improving the performance 28-04-2014.....
-				//
-				//			Sorting after the insertion of an individual:
-				//			aRobotSize = (37,29), radius = 23
-				//			Duration: 17.349.490 openSet: 1507 closedSet: 76521 predecessorMap: 78027
-				//
-				//			After the insert of all:
-				//			aRobotSize = (37,29), radius = 23
-				//			Duration: 7.733.159 openSet: 1507 closedSet: 76521 predecessorMap: 78027
-				//
-				//			Partial sort after insert of all:
-				//			aRobotSize = (37,29), radius = 23
-				//			Duration: 3.297.669 openSet: 1507 closedSet: 76521 predecessorMap: 78027
-				//
-				//			No sorting, just iterator swap for begin() and the minimum element, which is basically
-				//			the smallest partial_sort there is...
-				//			aRobotSize = (37,29), radius = 23
-				//			Duration: 2.626.220 openSet: 1507 closedSet: 76521 predecessorMap: 78027
-				//
-				//			// Sort the openSet before the next loop, use partial_sort as per Scott Meyers' Effective STL
-				//			if(std::distance(openSet.begin(), openSet.end()) > 5 )
-				//			{
-				//				std::partial_sort( openSet.begin(), openSet.begin() + 4, openSet.end(), VertexLessCostCompare());
-				//			}else
-				//			{
-				//				std::sort( openSet.begin(), openSet.end(), VertexLessCostCompare());
-				//			}
-				std::iter_swap(openSet.begin(), std::min_element( openSet.begin(), openSet.end(), VertexLessCostCompare()));
+				} //for(const Neighbour& candidate : neighbours)
 			}
 		}
-		// std::cerr << "Duration: " << (std::clock() - begin) << " openSet: " << getOS().size() << " closedSet: " << getCS().size() << " predecessorMap: " << getPM().size() << std::endl;
-
 		std::cerr << "**** No route from " << aStart << " to " << aGoal << std::endl;
 		return Path();
 	}
+	/**
+	 *
+	 */
+	std::size_t AStar::getAllocatedBytes() const
+	{
+		return openSet.getAllocatedBytes() + workspace.getAllocatedBytes();
+	}
 	/**
 	 *
 	 */
 	void AStar::addToOpenSet( const Vertex& aVertex)
 	{
-		std::unique_lock< std::recursive_mutex > lock( openSetMutex);
-		openSet.push_back( aVertex);
-		notifyObservers();
+		openSet.push( aVertex);
+		countGenerated( openSet.size());
+	}
+	/**
+	 *
+	 */
+	void AStar::updateInOpenSet( const Vertex& aVertex)
+	{
+		openSet.update( aVertex);
 	}
 	/**
 	 *
 	 */
 	void AStar::removeFromOpenSet( const Vertex& aVertex)
 	{
-		std::unique_lock< std::recursive_mutex > lock( openSetMutex);
 		OpenSet::iterator i = findInOpenSet( aVertex);
 		removeFromOpenSet( i);
 	}
@@ -280,89 +531,74 @@ namespace PathAlgorithm
 	 */
 	void AStar::removeFromOpenSet( OpenSet::iterator& i)
 	{
-		std::unique_lock< std::recursive_mutex > lock( openSetMutex);
 		openSet.erase( i);
-		notifyObservers();
 	}
 	/**
 	 *
 	 */
 	OpenSet::iterator AStar::findInOpenSet( const Vertex& aVertex)
 	{
-		std::unique_lock< std::recursive_mutex > lock( openSetMutex);
-		return std::find_if( openSet.begin(),
-							 openSet.end(),
-							 [aVertex](const Vertex& rhs)
-							 {
-			return aVertex.equalPoint(rhs);
-							 });
+		return openSet.find( aVertex);
 	}
 	/**
 	 *
 	 */
 	bool AStar::findRemoveInOpenSet( const Vertex& aVertex)
 	{
-		std::lock_guard< std::recursive_mutex > lock( openSetMutex);
-		OpenSet::iterator i = findInOpenSet( aVertex);
-		if (i != openSet.end())
-		{
-			openSet.erase( i);
-			return true;
-		}
-		return false;
-
+		return openSet.erase( aVertex);
 	}
 	/**
 	 *
 	 */
 	void AStar::removeFirstFromOpenSet()
 	{
-		std::unique_lock< std::recursive_mutex > lock( openSetMutex);
-		openSet.erase( openSet.begin());
+		openSet.pop();
 	}
 	/**
 	 *
 	 */
 	void AStar::addToClosedSet( const Vertex& aVertex)
 	{
-		std::unique_lock< std::recursive_mutex > lock( closedSetMutex);
-		closedSet.insert( aVertex);
-		notifyObservers();
+		workspace.setClosed( workspace.indexOf( aVertex.x, aVertex.y));
+		if (++closedCount > stats.peakClosedSize)
+		{
+			stats.peakClosedSize = closedCount;
+		}
 	}
 	/**
 	 *
 	 */
 	void AStar::removeFromClosedSet( const Vertex& aVertex)
 	{
-		std::unique_lock< std::recursive_mutex > lock( closedSetMutex);
-		ClosedSet::iterator i = findInClosedSet( aVertex);
-		removeFromClosedSet( i);
+		workspace.setClosed( workspace.indexOf( aVertex.x, aVertex.y), false);
+		--closedCount;
 	}
 	/**
 	 *
 	 */
-	void AStar::removeFromClosedSet( ClosedSet::iterator& i)
+	bool AStar::isInClosedSet( const Vertex& aVertex) const
 	{
-		std::unique_lock< std::recursive_mutex > lock( closedSetMutex);
-		closedSet.erase( i);
-		notifyObservers();
-	}
-	/**
-	 *
-	 */
-	ClosedSet::iterator AStar::findInClosedSet( const Vertex& aVertex)
-	{
-		std::unique_lock< std::recursive_mutex > lock( closedSetMutex);
-		//return std::find_if(closedSet.begin(),closedSet.end(),[aVertex](const Vertex& rhs){return aVertex.equalPoint(rhs);});
-		return closedSet.find( aVertex);
+		return workspace.contains( aVertex.x, aVertex.y) && workspace.isClosed( workspace.indexOf( aVertex.x, aVertex.y));
 	}
 	/**
 	 *
 	 */
 	ClosedSet AStar::getClosedSet() const
 	{
-		std::lock_guard< std::recursive_mutex > lock( closedSetMutex);
-		ClosedSet c = getCS();
+		ClosedSet c;
+		for (int y = 0; y < workspace.getHeight(); ++y)
+		{
+			for (int x = 0; x < workspace.getWidth(); ++x)
+			{
+				unsigned int index = workspace.indexOf( x, y);
+				if (workspace.isClosed( index))
+				{
+					Vertex vertex( x, y);
+					vertex.actualCost = workspace.getActualCost( index);
+					c.insert( vertex);
+				}
+			}
+		}
 		return c;
 	}
 	/**
@@ -370,11 +606,9 @@ namespace PathAlgorithm
 	 */
 	bool AStar::findRemoveClosedSet( const Vertex& aVertex)
 	{
-		std::lock_guard< std::recursive_mutex > lock( closedSetMutex);
-		ClosedSet::iterator i = findInClosedSet( aVertex);
-		if (i != closedSet.end())
+		if (isInClosedSet( aVertex))
 		{
-			closedSet.erase( i);
+			removeFromClosedSet( aVertex);
 			return true;
 		}
 		return false;
@@ -384,66 +618,97 @@ namespace PathAlgorithm
 	 */
 	OpenSet AStar::getOpenSet() const
 	{
-		std::lock_guard< std::recursive_mutex > lock( openSetMutex);
-		OpenSet o = getOS();
-		return o;
+		return openSet;
 	}
 	/**
 	 *
 	 */
 	VertexMap AStar::getPredecessorMap() const
 	{
-		std::lock_guard< std::recursive_mutex > lock( predecessorMapMutex);
-		VertexMap p = getPM();
+		VertexMap p;
+		for (int y = 0; y < workspace.getHeight(); ++y)
+		{
+			for (int x = 0; x < workspace.getWidth(); ++x)
+			{
+				unsigned int index = workspace.indexOf( x, y);
+				if (workspace.isVisited( index) && workspace.getParent( index) != SearchWorkspace::NoParent)
+				{
+					unsigned int parent = workspace.getParent( index);
+					p.insert( std::make_pair( Vertex( x, y), Vertex( workspace.xOf( parent), workspace.yOf( parent))));
+				}
+			}
+		}
 		return p;
 	}
-
 	/**
 	 *
 	 */
-	ClosedSet& AStar::getCS()
+	SearchSnapshotPtr AStar::getSnapshot() const
 	{
-		std::unique_lock< std::recursive_mutex > lock( closedSetMutex);
-		return closedSet;
+		return std::atomic_load( &snapshot);
 	}
 	/**
 	 *
 	 */
-	const ClosedSet& AStar::getCS() const
+	OpenSet& AStar::getOS()
 	{
-		std::unique_lock< std::recursive_mutex > lock( closedSetMutex);
-		return closedSet;
+		return openSet;
 	}
 	/**
 	 *
 	 */
-	OpenSet& AStar::getOS()
+	const OpenSet& AStar::getOS() const
 	{
-		std::unique_lock< std::recursive_mutex > lock( openSetMutex);
 		return openSet;
 	}
 	/**
 	 *
 	 */
-	const OpenSet& AStar::getOS() const
+	SearchWorkspace& AStar::getWS()
 	{
-		std::unique_lock< std::recursive_mutex > lock( openSetMutex);
-		return openSet;
+		return workspace;
+	}
+	/**
+	 *
+	 */
+	const SearchWorkspace& AStar::getWS() const
+	{
+		return workspace;
 	}
 	/**
 	 *
 	 */
-	VertexMap& AStar::getPM()
+	void AStar::publishProgress( unsigned int aCellIndex /* = SearchWorkspace::NoParent */)
 	{
-		std::unique_lock< std::recursive_mutex > lock( predecessorMapMutex);
-		return predecessorMap;
+		if (cancellationToken && cancellationToken->isCancelled())
+		{
+			throw SearchCancelled();
+		}
+
+		++expansionCount;
+		unsigned long interval = snapshotInterval.load( std::memory_order_relaxed);
+		if (interval == 0 || expansionCount % interval != 0)
+		{
+			return;
+		}
+
+		publishSnapshot( aCellIndex != SearchWorkspace::NoParent ? workspace.constructCompactPath( aCellIndex) : CompactPath());
 	}
 	/**
 	 *
 	 */
-	const VertexMap& AStar::getPM() const
+	void AStar::publishSnapshot( const CompactPath& aBestPath)
 	{
-		std::unique_lock< std::recursive_mutex > lock( predecessorMapMutex);
-		return predecessorMap;
+		std::shared_ptr< SearchSnapshot > progress = std::make_shared< SearchSnapshot >();
+		progress->frontier.reserve( openSet.size());
+		for (const Vertex& vertex : openSet)
+		{
+			progress->frontier.push_back( vertex.asPoint());
+		}
+		progress->bestPath = aBestPath;
+		progress->expandedCount = expansionCount;
+
+		std::atomic_store( &snapshot, SearchSnapshotPtr( progress));
+		notifyObservers();
 	}
 }// namespace PathAlgorithm
@@ -5,12 +5,17 @@
 
 #include <iostream>
 #include <map>
-#include <mutex>
+#include <atomic>
+#include <memory>
 #include <set>
 #include <vector>
 
+#include "CancellationToken.hpp"
+#include "CompactPath.hpp"
 #include "Notifier.hpp"
 #include "Point.hpp"
+#include "SearchStats.hpp"
+#include "SearchWorkspace.hpp"
 #include "Size.hpp"
 
 namespace PathAlgorithm
@@ -175,19 +180,342 @@ namespace PathAlgorithm
 	{
 		return os << anEdge.vertex1 << " -> " << anEdge.vertex2;
 	}
+	/**
+	 * A neighbour candidate of a vertex: only the cell and the kind of step, the costs are
+	 * calculated for the neighbours that are actually improved
+	 */
+	struct Neighbour
+	{
+			int x;
+			int y;
+			bool diagonal;
+	};
+	// struct Neighbour
+	/**
+	 * The free neighbours of a cell in a fixed-size buffer, so expanding a vertex does not
+	 * allocate
+	 */
+	struct Neighbours
+	{
+			/**
+			 *
+			 */
+			Neighbours() :
+				size( 0)
+			{
+			}
+			/**
+			 *
+			 */
+			const Neighbour* begin() const
+			{
+				return cells;
+			}
+			/**
+			 *
+			 */
+			const Neighbour* end() const
+			{
+				return cells + size;
+			}
+
+			Neighbour cells[8];
+			int size;
+	};
+	// struct Neighbours
+	/**
+	 * The open set of the search: an indexed binary min-heap on VertexLessCostCompare
+	 * with an O(1) coordinate index into the heap. The index makes membership tests and
+	 * decrease-key O(1) resp. O(log n) instead of a linear scan of the open vertices.
+	 *
+	 * The index is an open addressing hash table with linear probing, it only allocates when it
+	 * has to grow so a search that reuses the OpenSet does not allocate per vertex.
+	 *
+	 * Iteration visits the vertices in heap order, i.e. not sorted except for the first one.
+	 */
+	class OpenSet
+	{
+		public:
+			typedef std::vector< Vertex >::const_iterator const_iterator;
+			typedef const_iterator iterator;
+			/**
+			 *
+			 */
+			OpenSet();
+			/**
+			 *
+			 */
+			bool empty() const
+			{
+				return heap.empty();
+			}
+			/**
+			 *
+			 */
+			std::size_t size() const
+			{
+				return heap.size();
+			}
+			/**
+			 *
+			 */
+			void clear();
+			/**
+			 *
+			 */
+			void reserve( std::size_t aSize);
+			/**
+			 * @return the bytes held by the heap and its index
+			 */
+			std::size_t getAllocatedBytes() const;
+			/**
+			 * @return the vertex with the lowest cost
+			 */
+			const Vertex& top() const
+			{
+				return heap.front();
+			}
+			/**
+			 * Removes the vertex with the lowest cost
+			 */
+			void pop();
+			/**
+			 * Adds aVertex if there is no vertex with the same point in the set yet, otherwise
+			 * replaces the vertex with the same point and restores the heap order (decrease-key
+			 * and increase-key both work).
+			 */
+			void push( const Vertex& aVertex);
+			/**
+			 * Replaces the vertex with the same point as aVertex, returns false if there is none.
+			 */
+			bool update( const Vertex& aVertex);
+			/**
+			 *
+			 */
+			bool contains( const Vertex& aVertex) const
+			{
+				return positionOf( key( aVertex)) != NoPosition;
+			}
+			/**
+			 * @return an iterator to the vertex with the same point as aVertex or end()
+			 */
+			const_iterator find( const Vertex& aVertex) const;
+			/**
+			 *
+			 */
+			void erase( const_iterator i);
+			/**
+			 * @return true if a vertex with the same point as aVertex was removed
+			 */
+			bool erase( const Vertex& aVertex);
+			/**
+			 *
+			 */
+			const_iterator begin() const
+			{
+				return heap.begin();
+			}
+			/**
+			 *
+			 */
+			const_iterator end() const
+			{
+				return heap.end();
+			}
+
+		private:
+			static const std::size_t NoPosition = static_cast< std::size_t >(-1);
+			/**
+			 *
+			 */
+			static unsigned long long key( const Vertex& aVertex)
+			{
+				return (static_cast< unsigned long long >( static_cast< unsigned int >( aVertex.x)) << 32) | static_cast< unsigned int >( aVertex.y);
+			}
+			/**
+			 * @return the first slot of aKey in the index
+			 */
+			std::size_t homeSlot( unsigned long long aKey) const
+			{
+				return static_cast< std::size_t >((aKey * 0x9E3779B97F4A7C15ULL) >> 32) & slotMask;
+			}
+			/**
+			 * @return the slot that holds aKey or the empty slot where it would go
+			 */
+			std::size_t slotOf( unsigned long long aKey) const
+			{
+				std::size_t slot = homeSlot( aKey);
+				while (slotPositions[slot] != NoPosition && slotKeys[slot] != aKey)
+				{
+					slot = (slot + 1) & slotMask;
+				}
+				return slot;
+			}
+			/**
+			 * @return the heap position of aKey or NoPosition
+			 */
+			std::size_t positionOf( unsigned long long aKey) const
+			{
+				return slotPositions[slotOf( aKey)];
+			}
+			/**
+			 *
+			 */
+			void setPosition(	unsigned long long aKey,
+								std::size_t aPosition)
+			{
+				std::size_t slot = slotOf( aKey);
+				slotKeys[slot] = aKey;
+				slotPositions[slot] = aPosition;
+			}
+			/**
+			 *
+			 */
+			void removePosition( unsigned long long aKey);
+			/**
+			 * Makes the index at least twice as large as aSize and reinserts the heap
+			 */
+			void rehash( std::size_t aSize);
+			/**
+			 *
+			 */
+			void eraseAt( std::size_t aPosition);
+			/**
+			 *
+			 */
+			void siftUp( std::size_t aPosition);
+			/**
+			 *
+			 */
+			void siftDown( std::size_t aPosition);
+			/**
+			 *
+			 */
+			void place( std::size_t aPosition,
+						const Vertex& aVertex);
+
+			std::vector< Vertex > heap;
+			std::vector< unsigned long long > slotKeys;
+			std::vector< std::size_t > slotPositions;
+			std::size_t slotMask;
+	}; // class OpenSet
+	/**
+	 * An entry of the std::priority_queue of the planners that search their own graph instead of
+	 * the OpenSet: (estimated total cost, actual cost, the cell or node it is for). An improved
+	 * route adds a new entry, the old one is skipped when it comes first.
+	 */
+	template< typename anIndex >
+	struct OpenEntry
+	{
+			double heuristicCost;
+			double actualCost;
+			anIndex index;
+	};
+	// struct OpenEntry
+	/**
+	 * Orders the OpenEntries of a std::priority_queue: the lowest estimate first and of those the
+	 * one that got furthest
+	 */
+	struct OpenEntryGreater
+	{
+			template< typename anIndex >
+			bool operator()(	const OpenEntry< anIndex >& lhs,
+								const OpenEntry< anIndex >& rhs) const
+			{
+				if (lhs.heuristicCost != rhs.heuristicCost)
+				{
+					return lhs.heuristicCost > rhs.heuristicCost;
+				}
+				return lhs.actualCost < rhs.actualCost;
+			}
+	};
+	// struct OpenEntryGreater
+	/**
+	 * The number of expansions between two looks at the CancellationToken by the planners that
+	 * do not look at every expansion
+	 */
+	const unsigned long CancellationInterval = 256;
 	/*
 	 *
 	 */
 	typedef std::vector< Vertex > Path;
-	typedef std::vector< Vertex > OpenSet;
 	typedef std::set< Vertex, VertexLessIdCompare > ClosedSet;
 	typedef std::map< Vertex, Vertex, VertexLessIdCompare > VertexMap;
 	/**
+	 * The progress of a search: the points in the openSet, the route to the vertex that was
+	 * expanded last and the number of vertices expanded so far. A snapshot is never changed
+	 * after it is published, so any thread may read it.
+	 */
+	struct SearchSnapshot
+	{
+			std::vector< Point > frontier;
+			CompactPath bestPath;
+			unsigned long expandedCount;
+	};
+	// struct SearchSnapshot
+	typedef std::shared_ptr< const SearchSnapshot > SearchSnapshotPtr;
+	/**
+	 * The radius of the circle around a robot with aRobotSize, walls must be at least this far away
+	 */
+	int FreeRadius( const Size& aRobotSize);
+	/**
+	 * @return -1, 0 or 1
+	 */
+	inline int Sign( int aValue)
+	{
+		return (aValue > 0) - (aValue < 0);
+	}
+	class OccupancyGrid;
+	typedef std::shared_ptr< const OccupancyGrid > OccupancyGridPtr;
+	/**
+	 * Collects the free neighbours of aVertex in aNeighbours
+	 */
+	void GetNeighbours(	const Vertex& aVertex,
+						const OccupancyGrid& anOccupancyGrid,
+						Neighbours& aNeighbours);
+	/**
+	 * The cost of a diagonal step, sqrt(2), a straight step costs 1
+	 */
+	const double DiagonalStepCost = 1.4142135623730951;
+	/**
+	 *
+	 */
+	double ActualCost(	const Vertex& aStart,
+						const Vertex& aGoal);
+	/**
+	 *
+	 */
+	double HeuristicCost(	const Vertex& aStart,
+							const Vertex& aGoal);
+	/**
+	 * The search area: the occupancy grid, aStart and aGoal, anchored at (0,0)
+	 */
+	Size WorldBounds(	const Vertex& aStart,
+						const Vertex& aGoal,
+						const OccupancyGrid& anOccupancyGrid);
+
+	class AStar;
+	typedef std::shared_ptr< AStar > AStarPtr;
+	/**
+	 * The openSet and the workspace belong to the thread that runs the search and are not
+	 * locked. Other threads follow the search through the snapshots it publishes every
+	 * getSnapshotInterval() expansions; observers are notified once per snapshot.
+	 *
+	 * Every search through the Point overload also measures what it cost, see getStats().
 	 *
+	 * A search whose CancellationToken is cancelled throws SearchCancelled at its next expansion.
 	 */
 	class AStar : public Base::Notifier
 	{
 		public:
+			/**
+			 * The default number of expansions between two snapshots
+			 */
+			static const unsigned long DefaultSnapshotInterval = 1000;
+			/**
+			 *
+			 */
+			AStar();
 			/**
 			 *
 			 */
@@ -195,11 +523,48 @@ namespace PathAlgorithm
 						const Point& aGoalPoint,
 						const Size& aRobotSize);
 			/**
-			 *
+			 * As above, aSearchStats is set to what the search cost
 			 */
-			Path search(Vertex aStart,
-						const Vertex& aGoal,
-						const Size& aRobotSize);
+			Path search(const Point& aStartPoint,
+						const Point& aGoalPoint,
+						const Size& aRobotSize,
+						SearchStats& aSearchStats);
+			/**
+			 * As above, the route is searched in anOccupancyGrid instead of in the current walls of
+			 * the RobotWorld, see OccupancyGrid::Pin. The grid must be for the radius of aRobotSize.
+			 */
+			Path search(const Point& aStartPoint,
+						const Point& aGoalPoint,
+						const Size& aRobotSize,
+						const OccupancyGridPtr& anOccupancyGrid,
+						SearchStats& aSearchStats);
+			/**
+			 * Derived classes implement other search algorithms on the same grid, they share the
+			 * openSet and the workspace and publish their progress the same way.
+			 */
+			virtual Path search(Vertex aStart,
+								const Vertex& aGoal,
+								const Size& aRobotSize);
+			/**
+			 * @return true if the routes found by this planner only depend on the walls, so they may
+			 * be taken from and added to the PathCache
+			 */
+			virtual bool isCacheable() const
+			{
+				return true;
+			}
+			/**
+			 * @return the bytes held by the search structures of this planner
+			 */
+			virtual std::size_t getAllocatedBytes() const;
+			/**
+			 * @return the costs of the last search through the Point overload, only valid if no
+			 * search is running
+			 */
+			const SearchStats& getStats() const
+			{
+				return stats;
+			}
 			/**
 			 *
 			 */
@@ -212,6 +577,10 @@ namespace PathAlgorithm
 			 *
 			 */
 			void removeFromOpenSet( OpenSet::iterator& i);
+			/**
+			 *
+			 */
+			void updateInOpenSet( const Vertex& aVertex);
 			/**
 			 *
 			 */
@@ -235,37 +604,53 @@ namespace PathAlgorithm
 			/**
 			 *
 			 */
-			void removeFromClosedSet( ClosedSet::iterator& i);
-			/**
-			 *
-			 */
-			ClosedSet::iterator findInClosedSet( const Vertex& aVertex);
+			bool isInClosedSet( const Vertex& aVertex) const;
 			/**
 			 *
 			 */
 			bool findRemoveClosedSet( const Vertex& aVertex);
 			/**
-			 *
+			 * Builds the closed set from the search workspace, meant for debugging only and only
+			 * valid if no search is running
 			 */
 			ClosedSet getClosedSet() const;
 			/**
-			 *
+			 * Only valid if no search is running, use getSnapshot otherwise
 			 */
 			OpenSet getOpenSet() const;
 			/**
-			 *
+			 * Builds the predecessor map from the search workspace, meant for debugging only and
+			 * only valid if no search is running
 			 */
 			VertexMap getPredecessorMap() const;
-
-		protected:
 			/**
-			 *
+			 * @return the last snapshot of the current or the last search, may be empty
 			 */
-			ClosedSet& getCS();
+			SearchSnapshotPtr getSnapshot() const;
 			/**
 			 *
 			 */
-			const ClosedSet& getCS() const;
+			unsigned long getSnapshotInterval() const
+			{
+				return snapshotInterval;
+			}
+			/**
+			 * Publishes a snapshot every anInterval expansions, 0 turns the snapshots off
+			 */
+			void setSnapshotInterval( unsigned long anInterval)
+			{
+				snapshotInterval = anInterval;
+			}
+			/**
+			 * The searches from now on are cancelled through aCancellationToken, nullptr to search
+			 * without one. Set by the thread that runs the searches.
+			 */
+			void setCancellationToken( const CancellationTokenPtr& aCancellationToken)
+			{
+				cancellationToken = aCancellationToken;
+			}
+
+		protected:
 			/**
 			 *
 			 */
@@ -277,30 +662,82 @@ namespace PathAlgorithm
 			/**
 			 *
 			 */
-			VertexMap& getPM();
+			SearchWorkspace& getWS();
 			/**
 			 *
 			 */
-			const VertexMap& getPM() const;
-
-		private:
+			const SearchWorkspace& getWS() const;
 			/**
+			 * Counts an expansion and publishes a snapshot and notifies the observers if it is
+			 * time to. The best path is the route to aCellIndex in the workspace, if given.
 			 *
+			 * @throw SearchCancelled if the search was cancelled
+			 */
+			void publishProgress( unsigned int aCellIndex = SearchWorkspace::NoParent);
+			/**
+			 * Publishes a snapshot with aBestPath and the current openSet right away and notifies
+			 * the observers
+			 */
+			void publishSnapshot( const CompactPath& aBestPath);
+			/**
+			 * Counts a vertex that was added to an openSet holding anOpenSize vertices, for planners
+			 * that do not use addToOpenSet
+			 */
+			void countGenerated( std::size_t anOpenSize)
+			{
+				++stats.generatedCount;
+				if (anOpenSize > stats.peakOpenSize)
+				{
+					stats.peakOpenSize = anOpenSize;
+				}
+			}
+			/**
+			 * Counts anExpansionCount expansions by threads that do not call publishProgress, such
+			 * as the workers of a parallel search
 			 */
-			ClosedSet closedSet;
+			void countExpansions( unsigned long anExpansionCount)
+			{
+				expansionCount += anExpansionCount;
+			}
+			/**
+			 * @return true if the running search was cancelled, may be called by any thread that
+			 * takes part in the search
+			 */
+			bool isCancelled() const
+			{
+				return cancellationToken && cancellationToken->isCancelled();
+			}
+			/**
+			 * @return the estimated cost from aVertex to aGoal that AStar::search orders its openSet
+			 * by, the straight-line distance unless a derived class knows a better lower bound. It
+			 * must never overestimate.
+			 */
+			virtual double estimateCost(	const Vertex& aVertex,
+											const Vertex& aGoal) const
+			{
+				return HeuristicCost( aVertex, aGoal);
+			}
+
+		private:
 			/**
 			 *
 			 */
 			OpenSet openSet;
 			/**
-			 *
+			 * Closed flags, actual costs and predecessors of all cells in the world
 			 */
-			VertexMap predecessorMap;
+			SearchWorkspace workspace;
 
-			mutable std::recursive_mutex openSetMutex;
-			mutable std::recursive_mutex closedSetMutex;
-			mutable std::recursive_mutex predecessorMapMutex;
+			unsigned long expansionCount;
+			std::atomic< unsigned long > snapshotInterval;
 
+			SearchStats stats;
+			std::size_t closedCount;
+			CancellationTokenPtr cancellationToken;
+			/**
+			 * Only accessed with std::atomic_load and std::atomic_store
+			 */
+			SearchSnapshotPtr snapshot;
 	}; // class AStar
 } // namespace PathAlgorithm
 #endif // ASTAR_HPP_
@@ -0,0 +1,109 @@
+#include "AdaptiveAStar.hpp"
+#include "OccupancyGrid.hpp"
+#include <algorithm>
+
+namespace PathAlgorithm
+{
+	/* static */ const std::size_t AdaptiveAStar::MaxGoalCount;
+	/**
+	 *
+	 */
+	AdaptiveAStar::AdaptiveAStar()
+	{
+	}
+	/**
+	 *
+	 */
+	Path AdaptiveAStar::search(	Vertex aStart,
+								const Vertex& aGoal,
+								const Size& aRobotSize)
+	{
+		int radius = FreeRadius( aRobotSize);
+		OccupancyGridPtr occupancyGrid = OccupancyGrid::getOccupancyGrid( radius);
+		selectLearnedCosts( aGoal.asPoint(), radius, occupancyGrid->getWallRevision(), WorldBounds( aStart, aGoal, *occupancyGrid));
+
+		Path path = AStar::search( aStart, aGoal, aRobotSize);
+		if (!path.empty())
+		{
+			learn( path.back().actualCost);
+		}
+		return path;
+	}
+	/**
+	 *
+	 */
+	std::size_t AdaptiveAStar::getAllocatedBytes() const
+	{
+		std::size_t allocatedBytes = AStar::getAllocatedBytes();
+		for (const LearnedCosts& learned : learnedCosts)
+		{
+			allocatedBytes += learned.costs.capacity() * sizeof( double);
+		}
+		return allocatedBytes;
+	}
+	/**
+	 *
+	 */
+	double AdaptiveAStar::estimateCost(	const Vertex& aVertex,
+										const Vertex& aGoal) const
+	{
+		double heuristicCost = HeuristicCost( aVertex, aGoal);
+		const LearnedCosts& learned = learnedCosts.front();
+		if (aVertex.x < learned.width && aVertex.y < learned.height)
+		{
+			return std::max( heuristicCost, learned.costs[static_cast< std::size_t >(aVertex.y * learned.width + aVertex.x)]);
+		}
+		return heuristicCost;
+	}
+	/**
+	 *
+	 */
+	void AdaptiveAStar::selectLearnedCosts(	const Point& aGoal,
+											int aRadius,
+											unsigned long aWallRevision,
+											const Size& aBounds)
+	{
+		std::vector< LearnedCosts >::iterator i = std::find_if( learnedCosts.begin(), learnedCosts.end(), [&]( const LearnedCosts& learned)
+		{
+			return learned.goal == aGoal && learned.radius == aRadius;
+		});
+		if (i == learnedCosts.end())
+		{
+			if (learnedCosts.size() < MaxGoalCount)
+			{
+				learnedCosts.push_back( LearnedCosts());
+			}
+			// The least recently used goal makes way
+			i = learnedCosts.end() - 1;
+			i->goal = aGoal;
+			i->radius = aRadius;
+			i->width = 0;
+		}
+		std::rotate( learnedCosts.begin(), i, i + 1);
+
+		LearnedCosts& learned = learnedCosts.front();
+		if (learned.width != aBounds.x || learned.height != aBounds.y || learned.wallRevision != aWallRevision)
+		{
+			learned.wallRevision = aWallRevision;
+			learned.width = aBounds.x;
+			learned.height = aBounds.y;
+			learned.costs.assign( static_cast< std::size_t >(aBounds.x) * static_cast< std::size_t >(aBounds.y), 0.0);
+		}
+	}
+	/**
+	 *
+	 */
+	void AdaptiveAStar::learn( double aGoalCost)
+	{
+		const SearchWorkspace& searchWorkspace = getWS();
+		LearnedCosts& learned = learnedCosts.front();
+		for (unsigned int i = 0; i < learned.costs.size(); ++i)
+		{
+			// The cost of an expanded cell is final and no route through it beats the route found
+			if (searchWorkspace.isClosed( i))
+			{
+				learned.costs[i] = std::max( learned.costs[i], aGoalCost - searchWorkspace.getActualCost( i));
+			}
+		}
+	}
+} // namespace PathAlgorithm
@@ -0,0 +1,88 @@
+#ifndef ADAPTIVEASTAR_HPP_
+#define ADAPTIVEASTAR_HPP_
+
+#include "Config.hpp"
+
+#include <cstddef>
+#include <vector>
+
+#include "AStar.hpp"
+
+namespace PathAlgorithm
+{
+	/**
+	 * Adaptive A* (Koenig and Likhachev): A* that learns from its searches to the same goal. After
+	 * a search found a route to the goal, the cost of every expanded cell to the goal is at least
+	 * g(goal) - g(cell), that becomes the heuristic of the cell for the next searches to the goal.
+	 * The learned heuristic stays consistent, so the routes cost the same as those of AStar, but a
+	 * replan from further along the route expands fewer cells.
+	 *
+	 * The learned costs are kept per goal and robot radius for the last MaxGoalCount goals. They
+	 * are forgotten when the walls change: a removed wall may make a route cheaper than learned.
+	 */
+	class AdaptiveAStar : public AStar
+	{
+		public:
+			/**
+			 * The number of goals the learned costs are kept for
+			 */
+			static const std::size_t MaxGoalCount = 4;
+			/**
+			 *
+			 */
+			AdaptiveAStar();
+			using AStar::search;
+			/**
+			 *
+			 */
+			virtual Path search(Vertex aStart,
+								const Vertex& aGoal,
+								const Size& aRobotSize);
+			/**
+			 *
+			 */
+			virtual std::size_t getAllocatedBytes() const;
+
+		protected:
+			/**
+			 * @return the straight-line distance or the learned cost of aVertex, whichever is higher
+			 */
+			virtual double estimateCost(	const Vertex& aVertex,
+											const Vertex& aGoal) const;
+
+		private:
+			/**
+			 * The learned costs to a goal for the walls of a revision, per cell of the search area,
+			 * 0 if nothing was learned
+			 */
+			struct LearnedCosts
+			{
+					Point goal;
+					int radius;
+					unsigned long wallRevision;
+					int width;
+					int height;
+					std::vector< double > costs;
+			};
+			// struct LearnedCosts
+			/**
+			 * Makes the learned costs of the search the first ones, they are reset if they do not
+			 * match the walls or the search area
+			 */
+			void selectLearnedCosts(	const Point& aGoal,
+										int aRadius,
+										unsigned long aWallRevision,
+										const Size& aBounds);
+			/**
+			 * Raises the learned costs of the cells expanded by the last search, which reached the
+			 * goal at aGoalCost
+			 */
+			void learn( double aGoalCost);
+
+			/**
+			 * The most recently used first
+			 */
+			std::vector< LearnedCosts > learnedCosts;
+	}; // class AdaptiveAStar
+} // namespace PathAlgorithm
+#endif // ADAPTIVEASTAR_HPP_
@@ -0,0 +1,75 @@
+#include "AllocationCounter.hpp"
+#include <cstdlib>
+#include <new>
+
+namespace PathAlgorithm
+{
+	namespace
+	{
+		// Zero-initialised, so it is usable before any constructor of the thread ran
+		thread_local unsigned long allocationCount = 0;
+	} // namespace
+
+#ifdef COUNT_ALLOCATIONS
+	/**
+	 *
+	 */
+	/* static */ bool AllocationCounter::isCounting()
+	{
+		return true;
+	}
+#else
+	/**
+	 *
+	 */
+	/* static */ bool AllocationCounter::isCounting()
+	{
+		return false;
+	}
+#endif
+	/**
+	 *
+	 */
+	/* static */ unsigned long AllocationCounter::getAllocationCount()
+	{
+		return allocationCount;
+	}
+} // namespace PathAlgorithm
+
+#ifdef COUNT_ALLOCATIONS
+/**
+ * The array and nothrow forms of the standard library call these
+ */
+void* operator new( std::size_t aSize)
+{
+	++PathAlgorithm::allocationCount;
+	for (;;)
+	{
+		if (void* memory = std::malloc( aSize != 0 ? aSize : 1))
+		{
+			return memory;
+		}
+		std::new_handler handler = std::get_new_handler();
+		if (!handler)
+		{
+			throw std::bad_alloc();
+		}
+		handler();
+	}
+}
+/**
+ *
+ */
+void operator delete( void* aMemory) noexcept
+{
+	std::free( aMemory);
+}
+/**
+ *
+ */
+void operator delete(	void* aMemory,
+						std::size_t) noexcept
+{
+	std::free( aMemory);
+}
+#endif
@@ -0,0 +1,29 @@
+#ifndef ALLOCATIONCOUNTER_HPP_
+#define ALLOCATIONCOUNTER_HPP_
+
+#include "Config.hpp"
+
+namespace PathAlgorithm
+{
+	/**
+	 * Counts the heap allocations per thread, so the difference before and after a search is the
+	 * number of allocations of the search, see SearchStats::allocationCount.
+	 *
+	 * Counting replaces the global operator new and delete, so it is only compiled in when
+	 * COUNT_ALLOCATIONS is defined, e.g. by configuring with ROBOTWORLD_CPPFLAGS=-DCOUNT_ALLOCATIONS.
+	 * Otherwise the count stays 0.
+	 */
+	class AllocationCounter
+	{
+		public:
+			/**
+			 * @return true if the allocations are counted in this build
+			 */
+			static bool isCounting();
+			/**
+			 * @return the number of allocations by the calling thread since it started
+			 */
+			static unsigned long getAllocationCount();
+	}; // class AllocationCounter
+} // namespace PathAlgorithm
+#endif // ALLOCATIONCOUNTER_HPP_
@@ -0,0 +1,220 @@
+#include "AnytimeAStar.hpp"
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+namespace PathAlgorithm
+{
+	/**
+	 *
+	 */
+	AnytimeAStar::AnytimeAStar(	std::chrono::milliseconds aTimeBudget /* = std::chrono::milliseconds( 20) */,
+								double anInitialWeight /* = 3.0 */,
+								double aWeightDecrement /* = 0.5 */) :
+									timeBudget( aTimeBudget),
+									initialWeight( std::max( anInitialWeight, 1.0)),
+									weightDecrement( aWeightDecrement > 0.0 ? aWeightDecrement : 0.5),
+									weight( initialWeight),
+									suboptimalityBound( std::numeric_limits< double >::infinity()),
+									goalIndex( 0),
+									iteration( 0)
+	{
+	}
+	/**
+	 *
+	 */
+	Path AnytimeAStar::search(	Vertex aStart,
+								const Vertex& aGoal,
+								const Size& aRobotSize)
+	{
+		return search( aStart, aGoal, aRobotSize, std::chrono::steady_clock::now() + timeBudget);
+	}
+	/**
+	 *
+	 */
+	Path AnytimeAStar::search(	Vertex aStart,
+								const Vertex& aGoal,
+								const Size& aRobotSize,
+								std::chrono::steady_clock::time_point aDeadline)
+	{
+		getOS().clear();
+		suboptimalityBound = std::numeric_limits< double >::infinity();
+
+		occupancyGrid = OccupancyGrid::getOccupancyGrid( FreeRadius( aRobotSize));
+
+		SearchWorkspace& workspace = getWS();
+		Size bounds = WorldBounds( aStart, aGoal, *occupancyGrid);
+		workspace.resize( bounds.x, bounds.y);
+		if (!workspace.contains( aStart.x, aStart.y) || !workspace.contains( aGoal.x, aGoal.y))
+		{
+			std::cerr << "**** No route from " << aStart << " to " << aGoal << ": outside of the world" << std::endl;
+			return Path();
+		}
+
+		std::size_t size = static_cast< std::size_t >(bounds.x) * static_cast< std::size_t >(bounds.y);
+		if (closedIteration.size() < size)
+		{
+			closedIteration.assign( size, 0);
+			inconsistentIteration.assign( size, 0);
+			iteration = 0;
+		}
+		inconsistent.clear();
+		++iteration;
+
+		weight = initialWeight;
+		goalIndex = workspace.indexOf( aGoal.x, aGoal.y);
+
+		aStart.actualCost = 0.0;
+		aStart.heuristicCost = weight * HeuristicCost( aStart, aGoal);
+		workspace.visit( workspace.indexOf( aStart.x, aStart.y), 0.0, SearchWorkspace::NoParent);
+		addToOpenSet( aStart);
+
+		Path bestPath;
+		for (;;)
+		{
+			bool inTime = improvePath( aGoal, aDeadline);
+			if (workspace.isVisited( goalIndex))
+			{
+				// The weight itself only bounds a route of a completed iteration
+				double bound = inTime ? std::min( weight, calculateBound( aGoal)) : calculateBound( aGoal);
+				if (bestPath.empty() || workspace.getActualCost( goalIndex) < bestPath.back().actualCost)
+				{
+					bestPath = workspace.constructPath( goalIndex);
+					publishSnapshot( CompactPath( bestPath));
+				}
+				suboptimalityBound = std::min( suboptimalityBound, bound);
+			}
+			if (!inTime || suboptimalityBound <= 1.0 || (getOS().empty() && inconsistent.empty()))
+			{
+				break;
+			}
+
+			// Tighten the weight and continue from the costs found so far
+			weight = std::max( 1.0, std::min( weight - weightDecrement, suboptimalityBound));
+			reorderOpenSet( aGoal);
+		}
+
+		if (bestPath.empty())
+		{
+			std::cerr << "**** No route from " << aStart << " to " << aGoal << " within the time budget" << std::endl;
+		}
+		return bestPath;
+	}
+	/**
+	 *
+	 */
+	std::size_t AnytimeAStar::getAllocatedBytes() const
+	{
+		return AStar::getAllocatedBytes() + (closedIteration.capacity() + inconsistent.capacity() + inconsistentIteration.capacity()) * sizeof( unsigned int);
+	}
+	/**
+	 *
+	 */
+	bool AnytimeAStar::improvePath(	const Vertex& aGoal,
+									std::chrono::steady_clock::time_point aDeadline)
+	{
+		SearchWorkspace& workspace = getWS();
+
+		unsigned long expansions = 0;
+		while (!getOS().empty())
+		{
+			// The goal can not be improved by expanding vertices that do not cost less
+			if (workspace.isVisited( goalIndex) && getOS().top().heuristicCost >= workspace.getActualCost( goalIndex))
+			{
+				return true;
+			}
+			// Looking at the clock is not free
+			if ((++expansions & 0xFF) == 0 && std::chrono::steady_clock::now() >= aDeadline)
+			{
+				return false;
+			}
+
+			Vertex current = getOS().top();
+			unsigned int currentIndex = workspace.indexOf( current.x, current.y);
+			removeFirstFromOpenSet();
+			closedIteration[currentIndex] = iteration;
+			addToClosedSet( current);
+			publishProgress( currentIndex);
+
+			Neighbours neighbours;
+			GetNeighbours( current, *occupancyGrid, neighbours);
+			for (const Neighbour& candidate : neighbours)
+			{
+				if (!workspace.contains( candidate.x, candidate.y))
+				{
+					continue;
+				}
+				unsigned int neighbourIndex = workspace.indexOf( candidate.x, candidate.y);
+
+				double calculatedActualCost = current.actualCost + (candidate.diagonal ? DiagonalStepCost : 1.0);
+				if (workspace.isVisited( neighbourIndex) && workspace.getActualCost( neighbourIndex) <= calculatedActualCost)
+				{
+					continue;
+				}
+				workspace.visit( neighbourIndex, calculatedActualCost, currentIndex);
+
+				if (isClosed( neighbourIndex))
+				{
+					// Not expanded again in this iteration, but in the next one
+					if (inconsistentIteration[neighbourIndex] != iteration)
+					{
+						inconsistentIteration[neighbourIndex] = iteration;
+						inconsistent.push_back( neighbourIndex);
+					}
+					continue;
+				}
+
+				Vertex neighbour( candidate.x, candidate.y);
+				neighbour.actualCost = calculatedActualCost;
+				neighbour.heuristicCost = calculatedActualCost + weight * HeuristicCost( neighbour, aGoal);
+				addToOpenSet( neighbour);
+			}
+		}
+		return true;
+	}
+	/**
+	 *
+	 */
+	double AnytimeAStar::calculateBound( const Vertex& aGoal) const
+	{
+		const SearchWorkspace& workspace = getWS();
+
+		// Every route to the goal that is not known yet goes through an open or inconsistent vertex
+		double lowerBound = workspace.getActualCost( goalIndex);
+		for (const Vertex& vertex : getOS())
+		{
+			lowerBound = std::min( lowerBound, vertex.actualCost + HeuristicCost( vertex, aGoal));
+		}
+		for (unsigned int index : inconsistent)
+		{
+			Vertex vertex( workspace.xOf( index), workspace.yOf( index));
+			lowerBound = std::min( lowerBound, workspace.getActualCost( index) + HeuristicCost( vertex, aGoal));
+		}
+		return lowerBound > 0.0 ? workspace.getActualCost( goalIndex) / lowerBound : 1.0;
+	}
+	/**
+	 *
+	 */
+	void AnytimeAStar::reorderOpenSet( const Vertex& aGoal)
+	{
+		const SearchWorkspace& workspace = getWS();
+
+		std::vector< Vertex > open( getOS().begin(), getOS().end());
+		for (unsigned int index : inconsistent)
+		{
+			Vertex vertex( workspace.xOf( index), workspace.yOf( index));
+			vertex.actualCost = workspace.getActualCost( index);
+			open.push_back( vertex);
+		}
+		inconsistent.clear();
+
+		// A new iteration, nothing is closed or inconsistent anymore
+		++iteration;
+		getOS().clear();
+		for (Vertex& vertex : open)
+		{
+			vertex.heuristicCost = vertex.actualCost + weight * HeuristicCost( vertex, aGoal);
+			addToOpenSet( vertex);
+		}
+	}
+} // namespace PathAlgorithm
@@ -0,0 +1,129 @@
+#ifndef ANYTIMEASTAR_HPP_
+#define ANYTIMEASTAR_HPP_
+
+#include "Config.hpp"
+
+#include <chrono>
+#include <vector>
+
+#include "AStar.hpp"
+#include "OccupancyGrid.hpp"
+
+namespace PathAlgorithm
+{
+	/**
+	 * Anytime Repairing A* (Likhachev, Gordon and Thrun, 2003) on the same 8-connected grid as
+	 * AStar, with a wall-clock budget.
+	 *
+	 * The first route is found quickly with the heuristic inflated by the initial weight, the
+	 * route is then improved with ever smaller weights while the budget lasts. Each improvement
+	 * reuses the costs of the previous one and is published as a snapshot, so observers can use
+	 * it right away. The search returns the best route found when the budget runs out, or as soon
+	 * as the route is proven optimal. A route found with weight w is at most w times as long as
+	 * the shortest route.
+	 *
+	 * If no route at all is found within the budget an empty path is returned.
+	 */
+	class AnytimeAStar : public AStar
+	{
+		public:
+			using AStar::search;
+			/**
+			 *
+			 */
+			explicit AnytimeAStar(	std::chrono::milliseconds aTimeBudget = std::chrono::milliseconds( 20),
+									double anInitialWeight = 3.0,
+									double aWeightDecrement = 0.5);
+			/**
+			 * Searches until the time budget is used up or the route is optimal
+			 */
+			virtual Path search(Vertex aStart,
+								const Vertex& aGoal,
+								const Size& aRobotSize);
+			/**
+			 * Searches until aDeadline or until the route is optimal
+			 */
+			Path search(Vertex aStart,
+						const Vertex& aGoal,
+						const Size& aRobotSize,
+						std::chrono::steady_clock::time_point aDeadline);
+			/**
+			 * The routes depend on the time budget
+			 */
+			virtual bool isCacheable() const
+			{
+				return false;
+			}
+			/**
+			 *
+			 */
+			virtual std::size_t getAllocatedBytes() const;
+			/**
+			 *
+			 */
+			std::chrono::milliseconds getTimeBudget() const
+			{
+				return timeBudget;
+			}
+			/**
+			 *
+			 */
+			void setTimeBudget( std::chrono::milliseconds aTimeBudget)
+			{
+				timeBudget = aTimeBudget;
+			}
+			/**
+			 * @return the bound on the suboptimality of the route of the last search, 1 if it is
+			 * optimal and infinity if there is no route
+			 */
+			double getSuboptimalityBound() const
+			{
+				return suboptimalityBound;
+			}
+
+		private:
+			/**
+			 * Expands vertices with the current weight until the goal can not be improved anymore
+			 * or aDeadline passed
+			 *
+			 * @return false if aDeadline passed
+			 */
+			bool improvePath(	const Vertex& aGoal,
+								std::chrono::steady_clock::time_point aDeadline);
+			/**
+			 *
+			 */
+			bool isClosed( unsigned int anIndex) const
+			{
+				return closedIteration[anIndex] == iteration;
+			}
+			/**
+			 * @return the cost of the goal divided by the lowest possible cost of a route
+			 */
+			double calculateBound( const Vertex& aGoal) const;
+			/**
+			 * Puts the inconsistent vertices back into the openSet with the current weight
+			 */
+			void reorderOpenSet( const Vertex& aGoal);
+
+			std::chrono::milliseconds timeBudget;
+			double initialWeight;
+			double weightDecrement;
+			double weight;
+			double suboptimalityBound;
+
+			OccupancyGridPtr occupancyGrid;
+			unsigned int goalIndex;
+			/**
+			 * A vertex is closed in an iteration if its entry equals the iteration
+			 */
+			unsigned int iteration;
+			std::vector< unsigned int > closedIteration;
+			/**
+			 * The closed vertices whose cost decreased in this iteration
+			 */
+			std::vector< unsigned int > inconsistent;
+			std::vector< unsigned int > inconsistentIteration;
+	}; // class AnytimeAStar
+} // namespace PathAlgorithm
+#endif // ANYTIMEASTAR_HPP_
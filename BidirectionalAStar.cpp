@@ -0,0 +1,342 @@
+#include "BidirectionalAStar.hpp"
+#include "OccupancyGrid.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+namespace PathAlgorithm
+{
+	namespace
+	{
+		const unsigned int NoParent = std::numeric_limits< unsigned int >::max();
+
+		/**
+		 * The cheapest route found so far and the cell where its two halves meet
+		 */
+		struct Meeting
+		{
+				/**
+				 *
+				 */
+				Meeting() :
+								cost( std::numeric_limits< double >::infinity()),
+								cell( NoParent)
+				{
+				}
+				/**
+				 *
+				 */
+				void improve(	double aCost,
+								unsigned int aCell)
+				{
+					if (aCost >= cost.load())
+					{
+						return;
+					}
+					std::lock_guard< std::mutex > lock( mutex);
+					if (aCost < cost.load())
+					{
+						cost.store( aCost);
+						cell = aCell;
+					}
+				}
+
+				std::atomic< double > cost;
+				unsigned int cell;
+				std::mutex mutex;
+		};
+		// struct Meeting
+		/**
+		 * One frontier of the search, from its origin towards its target. The cells are expanded in
+		 * the order of their actual cost plus half the distance to the target minus half the
+		 * distance to the origin. The frontier from the other side uses the opposite of this
+		 * potential, so a step costs the same in both searches and the sum of the first keys of
+		 * the two frontiers is a lower bound of every route that is not found yet.
+		 */
+		class Direction
+		{
+			public:
+				/**
+				 *
+				 */
+				Direction(	const OccupancyGrid& anOccupancyGrid,
+							const Size& aBounds,
+							const Vertex& anOrigin,
+							const Vertex& aTarget,
+							std::vector< std::atomic< double > >& anActualCosts,
+							std::vector< unsigned int >& aParents,
+							Meeting& aMeeting) :
+								occupancyGrid( anOccupancyGrid),
+								width( aBounds.x),
+								height( aBounds.y),
+								origin( anOrigin),
+								target( aTarget),
+								actualCosts( anActualCosts),
+								parents( aParents),
+								other( nullptr),
+								meeting( aMeeting),
+								firstKey( 0.0),
+								expandedCount( 0)
+				{
+					unsigned int cell = static_cast< unsigned int >(origin.y * width + origin.x);
+					actualCosts[cell].store( 0.0);
+					parents[cell] = NoParent;
+					openCells.push( OpenEntry< unsigned int > { distance( cell, target) / 2.0, 0.0, cell });
+					firstKey.store( openCells.top().heuristicCost);
+				}
+				/**
+				 *
+				 */
+				void setOther( const Direction& anOther)
+				{
+					other = &anOther;
+				}
+				/**
+				 * Expands the first open cell
+				 *
+				 * @return false if the search has ended: there is no open cell left or no route
+				 * through the open cells of both frontiers can be cheaper than the cheapest one
+				 * found
+				 */
+				bool expandNext()
+				{
+					// Drops the entries that were improved upon after they were queued
+					while (!openCells.empty() && openCells.top().actualCost > actualCosts[openCells.top().index].load( std::memory_order_relaxed))
+					{
+						openCells.pop();
+					}
+					// The first key only grows, so an old one of the other frontier is never too high
+					firstKey.store( openCells.empty() ? std::numeric_limits< double >::infinity() : openCells.top().heuristicCost);
+					if (openCells.empty() || firstKey.load() + other->firstKey.load() >= meeting.cost.load())
+					{
+						return false;
+					}
+					OpenEntry< unsigned int > current = openCells.top();
+					openCells.pop();
+					++expandedCount;
+
+					Neighbours neighbours;
+					GetNeighbours( Vertex( static_cast< int >(current.index % static_cast< unsigned int >(width)), static_cast< int >(current.index / static_cast< unsigned int >(width))), occupancyGrid, neighbours);
+					for (const Neighbour& candidate : neighbours)
+					{
+						if (candidate.x < 0 || candidate.y < 0 || candidate.x >= width || candidate.y >= height)
+						{
+							continue;
+						}
+						unsigned int neighbour = static_cast< unsigned int >(candidate.y * width + candidate.x);
+						double actualCost = current.actualCost + (candidate.diagonal ? DiagonalStepCost : 1.0);
+						if (actualCost >= actualCosts[neighbour].load( std::memory_order_relaxed))
+						{
+							continue;
+						}
+						// Sequentially consistent with the load below: of two frontiers that reach a
+						// cell at the same time at least one sees the other
+						actualCosts[neighbour].store( actualCost);
+						parents[neighbour] = current.index;
+
+						double otherActualCost = other->actualCosts[neighbour].load();
+						if (!std::isinf( otherActualCost))
+						{
+							meeting.improve( actualCost + otherActualCost, neighbour);
+						}
+						// Nothing through the cell can beat the cheapest route found
+						double targetDistance = distance( neighbour, target);
+						if (actualCost + targetDistance < meeting.cost.load())
+						{
+							openCells.push( OpenEntry< unsigned int > { actualCost + (targetDistance - distance( neighbour, origin)) / 2.0, actualCost, neighbour });
+						}
+					}
+					return true;
+				}
+				/**
+				 *
+				 */
+				std::size_t getOpenSize() const
+				{
+					return openCells.size();
+				}
+				/**
+				 *
+				 */
+				unsigned long getExpandedCount() const
+				{
+					return expandedCount;
+				}
+
+			private:
+				/**
+				 *
+				 */
+				double distance(	unsigned int aCell,
+									const Vertex& aVertex) const
+				{
+					double dx = static_cast< int >(aCell % static_cast< unsigned int >(width)) - aVertex.x;
+					double dy = static_cast< int >(aCell / static_cast< unsigned int >(width)) - aVertex.y;
+					return std::sqrt( dx * dx + dy * dy);
+				}
+
+				const OccupancyGrid& occupancyGrid;
+				int width;
+				int height;
+				Vertex origin;
+				Vertex target;
+				std::vector< std::atomic< double > >& actualCosts;
+				std::vector< unsigned int >& parents;
+				const Direction* other;
+				Meeting& meeting;
+				std::priority_queue< OpenEntry< unsigned int >, std::vector< OpenEntry< unsigned int > >, OpenEntryGreater > openCells;
+				/**
+				 * The key of the first open cell, read by the other frontier
+				 */
+				std::atomic< double > firstKey;
+				unsigned long expandedCount;
+		}; // class Direction
+	} // namespace
+
+	/**
+	 *
+	 */
+	BidirectionalAStar::BidirectionalAStar( unsigned int aThreadCount /* = 0 */) :
+								threadCount( aThreadCount != 0 ? std::min( aThreadCount, 2u) : (std::thread::hardware_concurrency() > 1 ? 2 : 1))
+	{
+	}
+	/**
+	 *
+	 */
+	Path BidirectionalAStar::search(	Vertex aStart,
+										const Vertex& aGoal,
+										const Size& aRobotSize)
+	{
+		OccupancyGridPtr occupancyGrid = OccupancyGrid::getOccupancyGrid( FreeRadius( aRobotSize));
+		Size bounds = WorldBounds( aStart, aGoal, *occupancyGrid);
+		if (aStart.x < 0 || aStart.y < 0 || aGoal.x < 0 || aGoal.y < 0)
+		{
+			std::cerr << "**** No route from " << aStart << " to " << aGoal << ": outside of the world" << std::endl;
+			return Path();
+		}
+		// A frontier only steps onto free cells, so the frontier from the goal could never reach
+		// an occupied start. AStar leaves it through its free neighbours, e.g. after a collision.
+		if (!occupancyGrid->isFree( aStart.x, aStart.y))
+		{
+			return AStar::search( aStart, aGoal, aRobotSize);
+		}
+		// Nor could the frontier from the start reach an occupied goal
+		if (!occupancyGrid->isFree( aGoal.x, aGoal.y))
+		{
+			std::cerr << "**** No route from " << aStart << " to " << aGoal << ": occupied" << std::endl;
+			return Path();
+		}
+		std::size_t size = static_cast< std::size_t >(bounds.x) * static_cast< std::size_t >(bounds.y);
+		reset( forward, size);
+		reset( backward, size);
+
+		Meeting meeting;
+		Direction fromStart( *occupancyGrid, bounds, aStart, aGoal, forward.actualCosts, forward.parents, meeting);
+		Direction fromGoal( *occupancyGrid, bounds, aGoal, aStart, backward.actualCosts, backward.parents, meeting);
+		fromStart.setOther( fromGoal);
+		fromGoal.setOther( fromStart);
+		if (aStart.equalPoint( aGoal))
+		{
+			meeting.improve( 0.0, static_cast< unsigned int >(aStart.y * bounds.x + aStart.x));
+		}
+
+		std::atomic< bool > ended( false);
+		std::atomic< bool > cancelled( false);
+		// Expands aDirection, or with two directions the one with the fewest open cells, until
+		// either has ended
+		auto run = [&]( Direction& aDirection, Direction* anOtherDirection)
+		{
+			while (!ended.load( std::memory_order_relaxed))
+			{
+				Direction& next = (anOtherDirection && anOtherDirection->getOpenSize() < aDirection.getOpenSize()) ? *anOtherDirection : aDirection;
+				if (!next.expandNext())
+				{
+					break;
+				}
+				if (next.getExpandedCount() % CancellationInterval == 0 && isCancelled())
+				{
+					cancelled.store( true);
+					break;
+				}
+			}
+			ended.store( true);
+		};
+
+		if (threadCount > 1)
+		{
+			unsigned long backwardWallCheckCount = 0;
+			std::thread backwardThread( [&]()
+			{
+				unsigned long wallCheckCount = OccupancyGrid::getWallCheckCount();
+				run( fromGoal, nullptr);
+				backwardWallCheckCount = OccupancyGrid::getWallCheckCount() - wallCheckCount;
+			});
+			run( fromStart, nullptr);
+			backwardThread.join();
+			// Counted for the thread that runs the search
+			OccupancyGrid::countWallChecks( backwardWallCheckCount);
+		} else
+		{
+			run( fromStart, &fromGoal);
+		}
+
+		countExpansions( fromStart.getExpandedCount() + fromGoal.getExpandedCount());
+		if (cancelled.load())
+		{
+			throw SearchCancelled();
+		}
+		if (meeting.cell == NoParent)
+		{
+			std::cerr << "**** No route from " << aStart << " to " << aGoal << std::endl;
+			return Path();
+		}
+
+		// The forward half up to and including the meeting cell, then the backward half
+		Path path;
+		// From the costs of both halves, the meeting cost may have been recorded before either
+		// half got cheaper
+		double cost = forward.actualCosts[meeting.cell].load() + backward.actualCosts[meeting.cell].load();
+		for (unsigned int cell = meeting.cell; cell != NoParent; cell = forward.parents[cell])
+		{
+			Vertex vertex( static_cast< int >(cell % static_cast< unsigned int >(bounds.x)), static_cast< int >(cell / static_cast< unsigned int >(bounds.x)));
+			vertex.actualCost = vertex.heuristicCost = forward.actualCosts[cell].load();
+			path.push_back( vertex);
+		}
+		std::reverse( path.begin(), path.end());
+		for (unsigned int cell = backward.parents[meeting.cell]; cell != NoParent; cell = backward.parents[cell])
+		{
+			Vertex vertex( static_cast< int >(cell % static_cast< unsigned int >(bounds.x)), static_cast< int >(cell / static_cast< unsigned int >(bounds.x)));
+			vertex.actualCost = vertex.heuristicCost = cost - backward.actualCosts[cell].load();
+			path.push_back( vertex);
+		}
+		return path;
+	}
+	/**
+	 *
+	 */
+	std::size_t BidirectionalAStar::getAllocatedBytes() const
+	{
+		return AStar::getAllocatedBytes() + 2 * (forward.actualCosts.capacity() * sizeof( double) + forward.parents.capacity() * sizeof( unsigned int));
+	}
+	/**
+	 *
+	 */
+	/* static */ void BidirectionalAStar::reset(	Frontier& aFrontier,
+													std::size_t aSize)
+	{
+		if (aFrontier.actualCosts.size() != aSize)
+		{
+			// Atomics can not be copied, so the costs are allocated anew
+			aFrontier.actualCosts = std::vector< std::atomic< double > >( aSize);
+		}
+		for (std::atomic< double >& actualCost : aFrontier.actualCosts)
+		{
+			actualCost.store( std::numeric_limits< double >::infinity(), std::memory_order_relaxed);
+		}
+		aFrontier.parents.resize( aSize);
+	}
+} // namespace PathAlgorithm
@@ -0,0 +1,76 @@
+#ifndef BIDIRECTIONALASTAR_HPP_
+#define BIDIRECTIONALASTAR_HPP_
+
+#include "Config.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "AStar.hpp"
+
+namespace PathAlgorithm
+{
+	/**
+	 * Bidirectional A*: a search from the start towards the goal and one from the goal towards the
+	 * start. Where a frontier reaches a cell the other one has reached, the two routes make a route
+	 * from start to goal, the cheapest of those is kept.
+	 *
+	 * The frontiers use the balanced potentials of Ikeda et al.: half the straight-line distance
+	 * to the own target minus half that to the own origin. A step then costs the same whichever
+	 * frontier takes it, so the search may end as soon as the first keys of the two frontiers
+	 * add up to the cost of the cheapest route found, or either frontier runs out of cells. The
+	 * routes cost the same as those of AStar. With one thread the frontier with the fewest open
+	 * cells is expanded next, with two threads each frontier has a thread of its own.
+	 *
+	 * No snapshots are published and only the expansions are counted in the stats.
+	 */
+	class BidirectionalAStar : public AStar
+	{
+		public:
+			/**
+			 * aThreadCount is 1 or 2, 0 for two threads if there is more than one core
+			 */
+			explicit BidirectionalAStar( unsigned int aThreadCount = 0);
+			using AStar::search;
+			/**
+			 *
+			 */
+			virtual Path search(Vertex aStart,
+								const Vertex& aGoal,
+								const Size& aRobotSize);
+			/**
+			 *
+			 */
+			virtual std::size_t getAllocatedBytes() const;
+			/**
+			 *
+			 */
+			unsigned int getThreadCount() const
+			{
+				return threadCount;
+			}
+
+		private:
+			/**
+			 * Per cell the cost of the best route from the origin of a frontier and the cell it came
+			 * from. The costs are read by the other frontier while the search runs.
+			 */
+			struct Frontier
+			{
+					std::vector< std::atomic< double > > actualCosts;
+					std::vector< unsigned int > parents;
+			};
+			// struct Frontier
+			/**
+			 * Makes aFrontier cover aSize cells that are not reached yet
+			 */
+			static void reset(	Frontier& aFrontier,
+								std::size_t aSize);
+
+			unsigned int threadCount;
+			Frontier forward;
+			Frontier backward;
+	}; // class BidirectionalAStar
+} // namespace PathAlgorithm
+#endif // BIDIRECTIONALASTAR_HPP_
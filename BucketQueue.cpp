@@ -0,0 +1,108 @@
+#include "BucketQueue.hpp"
+#include <utility>
+
+namespace PathAlgorithm
+{
+	/**
+	 *
+	 */
+	BucketQueue::BucketQueue() :
+								buckets( 1),
+								mask( 0),
+								minimumKey( 0),
+								count( 0)
+	{
+	}
+	/**
+	 *
+	 */
+	void BucketQueue::reset( unsigned long aMaximumSpan)
+	{
+		std::size_t size = 1;
+		while (size <= aMaximumSpan)
+		{
+			size *= 2;
+		}
+		if (size > buckets.size())
+		{
+			buckets.resize( size);
+		}
+		for (std::vector< unsigned int >& bucket : buckets)
+		{
+			bucket.clear();
+		}
+		mask = buckets.size() - 1;
+		minimumKey = 0;
+		count = 0;
+	}
+	/**
+	 *
+	 */
+	void BucketQueue::push(	unsigned long aKey,
+							unsigned int aValue)
+	{
+		if (count == 0)
+		{
+			minimumKey = aKey;
+		} else if (aKey < minimumKey)
+		{
+			// Only for an inconsistent heuristic, the ring must cover the old keys as well
+			grow( minimumKey + mask + (minimumKey - aKey));
+			minimumKey = aKey;
+		}
+		if (aKey - minimumKey > mask)
+		{
+			grow( aKey);
+		}
+		buckets[aKey & mask].push_back( aValue);
+		++count;
+	}
+	/**
+	 *
+	 */
+	unsigned int BucketQueue::pop()
+	{
+		while (buckets[minimumKey & mask].empty())
+		{
+			++minimumKey;
+		}
+		std::vector< unsigned int >& bucket = buckets[minimumKey & mask];
+		unsigned int value = bucket.back();
+		bucket.pop_back();
+		--count;
+		return value;
+	}
+	/**
+	 *
+	 */
+	std::size_t BucketQueue::getAllocatedBytes() const
+	{
+		std::size_t bytes = buckets.capacity() * sizeof( std::vector< unsigned int >);
+		for (const std::vector< unsigned int >& bucket : buckets)
+		{
+			bytes += bucket.capacity() * sizeof( unsigned int);
+		}
+		return bytes;
+	}
+	/**
+	 *
+	 */
+	void BucketQueue::grow( unsigned long aKey)
+	{
+		std::size_t size = buckets.size();
+		while (aKey - minimumKey >= size)
+		{
+			size *= 2;
+		}
+
+		// The keys of the entries follow from their bucket and the smallest key
+		std::vector< std::vector< unsigned int > > old( size);
+		old.swap( buckets);
+		for (std::size_t i = 0; i < old.size(); ++i)
+		{
+			unsigned long key = minimumKey + ((i - minimumKey) & mask);
+			buckets[key & (size - 1)].swap( old[i]);
+		}
+		mask = size - 1;
+	}
+} // namespace PathAlgorithm
@@ -0,0 +1,80 @@
+#ifndef BUCKETQUEUE_HPP_
+#define BUCKETQUEUE_HPP_
+
+#include "Config.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace PathAlgorithm
+{
+	/**
+	 * A monotone priority queue on integer keys: a ring of buckets, one per key, that is walked
+	 * from the smallest key upwards. push and pop are O(1) amortised as long as the keys that are
+	 * pushed are not smaller than the last key that was popped, which holds for A* with integer
+	 * costs and a consistent heuristic. Vertices with equal keys come out last in, first out,
+	 * which favours the deeper vertices just like VertexLessCostCompare does.
+	 *
+	 * There is no decrease-key: a vertex that gets a lower cost is simply pushed again and the
+	 * caller skips the outdated entry when it is popped.
+	 */
+	class BucketQueue
+	{
+		public:
+			/**
+			 *
+			 */
+			BucketQueue();
+			/**
+			 * Empties the queue and sizes the ring for keys that differ at most aMaximumSpan from
+			 * the smallest key in the queue. The ring grows if it turns out to be too small.
+			 */
+			void reset( unsigned long aMaximumSpan);
+			/**
+			 *
+			 */
+			bool empty() const
+			{
+				return count == 0;
+			}
+			/**
+			 *
+			 */
+			std::size_t size() const
+			{
+				return count;
+			}
+			/**
+			 *
+			 */
+			void push(	unsigned long aKey,
+						unsigned int aValue);
+			/**
+			 * @return the value with the smallest key, the queue must not be empty
+			 */
+			unsigned int pop();
+			/**
+			 * @return the smallest key, only valid if the queue is not empty
+			 */
+			unsigned long getMinimumKey() const
+			{
+				return minimumKey;
+			}
+			/**
+			 * @return the bytes held by the buckets
+			 */
+			std::size_t getAllocatedBytes() const;
+
+		private:
+			/**
+			 * Makes the ring large enough for keys up to aKey
+			 */
+			void grow( unsigned long aKey);
+
+			std::vector< std::vector< unsigned int > > buckets;
+			unsigned long mask;
+			unsigned long minimumKey;
+			std::size_t count;
+	}; // class BucketQueue
+} // namespace PathAlgorithm
+#endif // BUCKETQUEUE_HPP_
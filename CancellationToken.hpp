@@ -0,0 +1,63 @@
+#ifndef CANCELLATIONTOKEN_HPP_
+#define CANCELLATIONTOKEN_HPP_
+
+#include "Config.hpp"
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+
+namespace PathAlgorithm
+{
+	/**
+	 * Shared by the one who asked for a route and the thread that searches it. Cancelling is a
+	 * single store, the search sees it at its next expansion.
+	 */
+	class CancellationToken
+	{
+		public:
+			/**
+			 *
+			 */
+			CancellationToken() :
+								cancelled( false)
+			{
+			}
+			/**
+			 *
+			 */
+			void cancel()
+			{
+				cancelled.store( true, std::memory_order_relaxed);
+			}
+			/**
+			 *
+			 */
+			bool isCancelled() const
+			{
+				return cancelled.load( std::memory_order_relaxed);
+			}
+
+		private:
+			CancellationToken( const CancellationToken&) = delete;
+			CancellationToken& operator=( const CancellationToken&) = delete;
+
+			std::atomic< bool > cancelled;
+	}; // class CancellationToken
+	typedef std::shared_ptr< CancellationToken > CancellationTokenPtr;
+	/**
+	 * Thrown out of a search whose CancellationToken was cancelled
+	 */
+	class SearchCancelled : public std::runtime_error
+	{
+		public:
+			/**
+			 *
+			 */
+			SearchCancelled() :
+								std::runtime_error( "search cancelled")
+			{
+			}
+	}; // class SearchCancelled
+} // namespace PathAlgorithm
+#endif // CANCELLATIONTOKEN_HPP_
@@ -0,0 +1,478 @@
+#include "ClusterGraph.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+
+namespace PathAlgorithm
+{
+	namespace
+	{
+		const double Infinity = std::numeric_limits< double >::infinity();
+		const double DiagonalCost = std::sqrt( 2.0);
+		const unsigned int NoCell = static_cast< unsigned int >(-1);
+	}
+	/**
+	 *
+	 */
+	ClusterGraph::ClusterGraph( int aClusterSize) :
+								clusterSize( aClusterSize),
+								width( 0),
+								height( 0),
+								clustersX( 0),
+								clustersY( 0),
+								wallRevision( 0),
+								recomputedCount( 0)
+	{
+	}
+	/**
+	 *
+	 */
+	void ClusterGraph::synchronise(	const OccupancyGridPtr& anOccupancyGrid,
+									int aWidth,
+									int aHeight)
+	{
+		recomputedCount = 0;
+
+		if (aWidth != width || aHeight != height || clusters.empty())
+		{
+			width = aWidth;
+			height = aHeight;
+			clustersX = (width + clusterSize - 1) / clusterSize;
+			clustersY = (height + clusterSize - 1) / clusterSize;
+
+			blocked.assign( static_cast< std::size_t >(width) * static_cast< std::size_t >(height), false);
+			for (int y = 0; y < height; ++y)
+			{
+				for (int x = 0; x < width; ++x)
+				{
+					blocked[cellOf( x, y)] = !anOccupancyGrid->isFree( x, y);
+				}
+			}
+
+			std::size_t numberOfClusters = static_cast< std::size_t >(clustersX) * static_cast< std::size_t >(clustersY);
+			clusters.assign( numberOfClusters, Cluster());
+			verticalBorders.assign( numberOfClusters, std::vector< Transition >());
+			horizontalBorders.assign( numberOfClusters, std::vector< Transition >());
+			corners.assign( numberOfClusters, std::vector< Transition >());
+			for (int clusterY = 0; clusterY < clustersY; ++clusterY)
+			{
+				for (int clusterX = 0; clusterX < clustersX; ++clusterX)
+				{
+					Cluster& cluster = clusters[static_cast< std::size_t >(clusterY * clustersX + clusterX)];
+					cluster.minX = clusterX * clusterSize;
+					cluster.minY = clusterY * clusterSize;
+					cluster.maxX = std::min( width, (clusterX + 1) * clusterSize) - 1;
+					cluster.maxY = std::min( height, (clusterY + 1) * clusterSize) - 1;
+				}
+			}
+			for (int clusterY = 0; clusterY < clustersY; ++clusterY)
+			{
+				for (int clusterX = 0; clusterX < clustersX; ++clusterX)
+				{
+					computeVerticalBorder( clusterX, clusterY);
+					computeHorizontalBorder( clusterX, clusterY);
+					computeCorner( clusterX, clusterY);
+				}
+			}
+			for (int clusterY = 0; clusterY < clustersY; ++clusterY)
+			{
+				for (int clusterX = 0; clusterX < clustersX; ++clusterX)
+				{
+					computeNodes( clusterX, clusterY);
+					computeDistances( clusters[static_cast< std::size_t >(clusterY * clustersX + clusterX)]);
+				}
+			}
+		} else if (anOccupancyGrid->getWallRevision() != wallRevision)
+		{
+			std::vector< bool > dirty( clusters.size(), false);
+			for (int y = 0; y < height; ++y)
+			{
+				for (int x = 0; x < width; ++x)
+				{
+					bool isBlocked = !anOccupancyGrid->isFree( x, y);
+					if (blocked[cellOf( x, y)] != isBlocked)
+					{
+						blocked[cellOf( x, y)] = isBlocked;
+						dirty[getClusterIndex( x, y)] = true;
+					}
+				}
+			}
+
+			// The borders and corners of a dirty cluster are shared with its neighbours
+			std::vector< bool > touched( clusters.size(), false);
+			for (int clusterY = 0; clusterY < clustersY; ++clusterY)
+			{
+				for (int clusterX = 0; clusterX < clustersX; ++clusterX)
+				{
+					if (!dirty[static_cast< std::size_t >(clusterY * clustersX + clusterX)])
+					{
+						continue;
+					}
+					for (int y = std::max( clusterY - 1, 0); y <= clusterY; ++y)
+					{
+						for (int x = std::max( clusterX - 1, 0); x <= clusterX; ++x)
+						{
+							computeCorner( x, y);
+						}
+					}
+					computeVerticalBorder( clusterX, clusterY);
+					computeHorizontalBorder( clusterX, clusterY);
+					if (clusterX > 0)
+					{
+						computeVerticalBorder( clusterX - 1, clusterY);
+					}
+					if (clusterY > 0)
+					{
+						computeHorizontalBorder( clusterX, clusterY - 1);
+					}
+					for (int y = std::max( clusterY - 1, 0); y <= std::min( clusterY + 1, clustersY - 1); ++y)
+					{
+						for (int x = std::max( clusterX - 1, 0); x <= std::min( clusterX + 1, clustersX - 1); ++x)
+						{
+							touched[static_cast< std::size_t >(y * clustersX + x)] = true;
+						}
+					}
+				}
+			}
+			for (int clusterY = 0; clusterY < clustersY; ++clusterY)
+			{
+				for (int clusterX = 0; clusterX < clustersX; ++clusterX)
+				{
+					std::size_t index = static_cast< std::size_t >(clusterY * clustersX + clusterX);
+					if (touched[index] && (computeNodes( clusterX, clusterY) || dirty[index]))
+					{
+						computeDistances( clusters[index]);
+					}
+				}
+			}
+		} else
+		{
+			return;
+		}
+
+		wallRevision = anOccupancyGrid->getWallRevision();
+		indexNodes();
+	}
+	/**
+	 *
+	 */
+	void ClusterGraph::getEdges(	unsigned int aCell,
+									std::vector< Edge >& anEdges) const
+	{
+		std::unordered_map< unsigned int, std::vector< Edge > >::const_iterator node = nodes.find( aCell);
+		if (node == nodes.end())
+		{
+			return;
+		}
+
+		const Cluster& cluster = clusters[getClusterIndex( static_cast< int >(aCell % static_cast< unsigned int >(width)), static_cast< int >(aCell / static_cast< unsigned int >(width)))];
+		std::size_t numberOfNodes = cluster.nodes.size();
+		std::size_t position = static_cast< std::size_t >(std::lower_bound( cluster.nodes.begin(), cluster.nodes.end(), aCell) - cluster.nodes.begin());
+		for (std::size_t i = 0; i < numberOfNodes; ++i)
+		{
+			double distance = cluster.distances[position * numberOfNodes + i];
+			if (i != position && distance != Infinity)
+			{
+				anEdges.push_back( Edge( cluster.nodes[i], distance));
+			}
+		}
+		anEdges.insert( anEdges.end(), (*node).second.begin(), (*node).second.end());
+	}
+	/**
+	 *
+	 */
+	void ClusterGraph::searchCluster(	const Cluster& aCluster,
+										unsigned int aCell,
+										std::vector< double >& aDistances,
+										std::vector< unsigned int >& aParents,
+										unsigned int aTarget /* = static_cast< unsigned int >(-1) */) const
+	{
+		static int xOffset[] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+		static int yOffset[] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+
+		int clusterWidth = aCluster.maxX - aCluster.minX + 1;
+		int clusterHeight = aCluster.maxY - aCluster.minY + 1;
+		aDistances.assign( static_cast< std::size_t >(clusterWidth * clusterHeight), Infinity);
+		aParents.assign( aDistances.size(), NoCell);
+
+		typedef std::pair< double, unsigned int > Entry;
+		std::priority_queue< Entry, std::vector< Entry >, std::greater< Entry > > queue;
+
+		unsigned int local = static_cast< unsigned int >((static_cast< int >(aCell / static_cast< unsigned int >(width)) - aCluster.minY) * clusterWidth + static_cast< int >(aCell % static_cast< unsigned int >(width)) - aCluster.minX);
+		aDistances[local] = 0.0;
+		queue.push( Entry( 0.0, local));
+
+		while (!queue.empty())
+		{
+			Entry entry = queue.top();
+			queue.pop();
+			if (entry.first > aDistances[entry.second])
+			{
+				continue;
+			}
+
+			int x = aCluster.minX + static_cast< int >(entry.second % static_cast< unsigned int >(clusterWidth));
+			int y = aCluster.minY + static_cast< int >(entry.second / static_cast< unsigned int >(clusterWidth));
+			if (cellOf( x, y) == aTarget)
+			{
+				break;
+			}
+
+			for (int i = 0; i < 8; ++i)
+			{
+				int neighbourX = x + xOffset[i];
+				int neighbourY = y + yOffset[i];
+				if (neighbourX < aCluster.minX || neighbourY < aCluster.minY || neighbourX > aCluster.maxX || neighbourY > aCluster.maxY || !isFree( neighbourX, neighbourY))
+				{
+					continue;
+				}
+				unsigned int neighbour = static_cast< unsigned int >((neighbourY - aCluster.minY) * clusterWidth + neighbourX - aCluster.minX);
+				double distance = entry.first + (xOffset[i] != 0 && yOffset[i] != 0 ? DiagonalCost : 1.0);
+				if (distance < aDistances[neighbour])
+				{
+					aDistances[neighbour] = distance;
+					aParents[neighbour] = entry.second;
+					queue.push( Entry( distance, neighbour));
+				}
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	void ClusterGraph::computeVerticalBorder(	int aClusterX,
+												int aClusterY)
+	{
+		std::vector< Transition >& transitions = verticalBorders[static_cast< std::size_t >(aClusterY * clustersX + aClusterX)];
+		transitions.clear();
+		if (aClusterX + 1 >= clustersX)
+		{
+			return;
+		}
+
+		const Cluster& cluster = clusters[static_cast< std::size_t >(aClusterY * clustersX + aClusterX)];
+		int x = cluster.maxX;
+
+		int first = -1;
+		for (int y = cluster.minY; y <= cluster.maxY + 1; ++y)
+		{
+			if (y <= cluster.maxY && isFree( x, y) && isFree( x + 1, y))
+			{
+				if (first < 0)
+				{
+					first = y;
+				}
+			} else if (first >= 0)
+			{
+				addRun( transitions, first, y - 1, x, true);
+				first = -1;
+			}
+		}
+
+		// Diagonal crossings that are not next to a straight crossing
+		for (int y = cluster.minY; y < cluster.maxY; ++y)
+		{
+			if ((isFree( x, y) && isFree( x + 1, y)) || (isFree( x, y + 1) && isFree( x + 1, y + 1)))
+			{
+				continue;
+			}
+			if (isFree( x, y) && isFree( x + 1, y + 1))
+			{
+				transitions.push_back( Transition { cellOf( x, y), cellOf( x + 1, y + 1), DiagonalCost });
+			}
+			if (isFree( x, y + 1) && isFree( x + 1, y))
+			{
+				transitions.push_back( Transition { cellOf( x, y + 1), cellOf( x + 1, y), DiagonalCost });
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	void ClusterGraph::computeHorizontalBorder(	int aClusterX,
+												int aClusterY)
+	{
+		std::vector< Transition >& transitions = horizontalBorders[static_cast< std::size_t >(aClusterY * clustersX + aClusterX)];
+		transitions.clear();
+		if (aClusterY + 1 >= clustersY)
+		{
+			return;
+		}
+
+		const Cluster& cluster = clusters[static_cast< std::size_t >(aClusterY * clustersX + aClusterX)];
+		int y = cluster.maxY;
+
+		int first = -1;
+		for (int x = cluster.minX; x <= cluster.maxX + 1; ++x)
+		{
+			if (x <= cluster.maxX && isFree( x, y) && isFree( x, y + 1))
+			{
+				if (first < 0)
+				{
+					first = x;
+				}
+			} else if (first >= 0)
+			{
+				addRun( transitions, first, x - 1, y, false);
+				first = -1;
+			}
+		}
+
+		// Diagonal crossings that are not next to a straight crossing
+		for (int x = cluster.minX; x < cluster.maxX; ++x)
+		{
+			if ((isFree( x, y) && isFree( x, y + 1)) || (isFree( x + 1, y) && isFree( x + 1, y + 1)))
+			{
+				continue;
+			}
+			if (isFree( x, y) && isFree( x + 1, y + 1))
+			{
+				transitions.push_back( Transition { cellOf( x, y), cellOf( x + 1, y + 1), DiagonalCost });
+			}
+			if (isFree( x + 1, y) && isFree( x, y + 1))
+			{
+				transitions.push_back( Transition { cellOf( x + 1, y), cellOf( x, y + 1), DiagonalCost });
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	void ClusterGraph::computeCorner(	int aClusterX,
+										int aClusterY)
+	{
+		std::vector< Transition >& transitions = corners[static_cast< std::size_t >(aClusterY * clustersX + aClusterX)];
+		transitions.clear();
+		if (aClusterX + 1 >= clustersX || aClusterY + 1 >= clustersY)
+		{
+			return;
+		}
+
+		const Cluster& cluster = clusters[static_cast< std::size_t >(aClusterY * clustersX + aClusterX)];
+		int x = cluster.maxX;
+		int y = cluster.maxY;
+
+		// Going around the corner through one of the other two clusters crosses a border instead
+		if (isFree( x, y) && isFree( x + 1, y + 1) && !isFree( x + 1, y) && !isFree( x, y + 1))
+		{
+			transitions.push_back( Transition { cellOf( x, y), cellOf( x + 1, y + 1), DiagonalCost });
+		}
+		if (isFree( x + 1, y) && isFree( x, y + 1) && !isFree( x, y) && !isFree( x + 1, y + 1))
+		{
+			transitions.push_back( Transition { cellOf( x + 1, y), cellOf( x, y + 1), DiagonalCost });
+		}
+	}
+	/**
+	 *
+	 */
+	void ClusterGraph::addRun(	std::vector< Transition >& aTransitions,
+								int aFirst,
+								int aLast,
+								int aBorder,
+								bool aVertical) const
+	{
+		std::vector< int > crossings;
+		if (aLast - aFirst + 1 < 6)
+		{
+			crossings.push_back( (aFirst + aLast) / 2);
+		} else
+		{
+			// A wide entrance gets a transition at both ends
+			crossings.push_back( aFirst);
+			crossings.push_back( aLast);
+		}
+		for (int crossing : crossings)
+		{
+			if (aVertical)
+			{
+				aTransitions.push_back( Transition { cellOf( aBorder, crossing), cellOf( aBorder + 1, crossing), 1.0 });
+			} else
+			{
+				aTransitions.push_back( Transition { cellOf( crossing, aBorder), cellOf( crossing, aBorder + 1), 1.0 });
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	bool ClusterGraph::computeNodes(	int aClusterX,
+										int aClusterY)
+	{
+		unsigned int clusterIndex = static_cast< unsigned int >(aClusterY * clustersX + aClusterX);
+
+		std::vector< unsigned int > clusterNodes;
+		for (int y = std::max( aClusterY - 1, 0); y <= aClusterY; ++y)
+		{
+			for (int x = std::max( aClusterX - 1, 0); x <= aClusterX; ++x)
+			{
+				std::size_t index = static_cast< std::size_t >(y * clustersX + x);
+				for (const std::vector< Transition >* transitions : { &verticalBorders[index], &horizontalBorders[index], &corners[index] })
+				{
+					for (const Transition& transition : *transitions)
+					{
+						for (unsigned int cell : { transition.cell1, transition.cell2 })
+						{
+							if (getClusterIndex( static_cast< int >(cell % static_cast< unsigned int >(width)), static_cast< int >(cell / static_cast< unsigned int >(width))) == clusterIndex)
+							{
+								clusterNodes.push_back( cell);
+							}
+						}
+					}
+				}
+			}
+		}
+		std::sort( clusterNodes.begin(), clusterNodes.end());
+		clusterNodes.erase( std::unique( clusterNodes.begin(), clusterNodes.end()), clusterNodes.end());
+
+		Cluster& cluster = clusters[clusterIndex];
+		if (clusterNodes == cluster.nodes)
+		{
+			return false;
+		}
+		cluster.nodes.swap( clusterNodes);
+		return true;
+	}
+	/**
+	 *
+	 */
+	void ClusterGraph::computeDistances( Cluster& aCluster)
+	{
+		std::size_t numberOfNodes = aCluster.nodes.size();
+		aCluster.distances.assign( numberOfNodes * numberOfNodes, Infinity);
+
+		int clusterWidth = aCluster.maxX - aCluster.minX + 1;
+		std::vector< double > distances;
+		std::vector< unsigned int > parents;
+		for (std::size_t i = 0; i < numberOfNodes; ++i)
+		{
+			searchCluster( aCluster, aCluster.nodes[i], distances, parents);
+			for (std::size_t j = 0; j < numberOfNodes; ++j)
+			{
+				int x = static_cast< int >(aCluster.nodes[j] % static_cast< unsigned int >(width));
+				int y = static_cast< int >(aCluster.nodes[j] / static_cast< unsigned int >(width));
+				aCluster.distances[i * numberOfNodes + j] = distances[static_cast< std::size_t >((y - aCluster.minY) * clusterWidth + x - aCluster.minX)];
+			}
+		}
+		++recomputedCount;
+	}
+	/**
+	 *
+	 */
+	void ClusterGraph::indexNodes()
+	{
+		nodes.clear();
+		for (const std::vector< std::vector< Transition > >* borders : { &verticalBorders, &horizontalBorders, &corners })
+		{
+			for (const std::vector< Transition >& transitions : *borders)
+			{
+				for (const Transition& transition : transitions)
+				{
+					nodes[transition.cell1].push_back( Edge( transition.cell2, transition.cost));
+					nodes[transition.cell2].push_back( Edge( transition.cell1, transition.cost));
+				}
+			}
+		}
+	}
+} // namespace PathAlgorithm
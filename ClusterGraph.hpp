@@ -0,0 +1,198 @@
+#ifndef CLUSTERGRAPH_HPP_
+#define CLUSTERGRAPH_HPP_
+
+#include "Config.hpp"
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "OccupancyGrid.hpp"
+
+namespace PathAlgorithm
+{
+	/**
+	 * The abstract graph of hierarchical path finding (HPA*, Botea, Mueller and Schaeffer, 2004).
+	 *
+	 * The grid is divided in square clusters. Wherever a robot can cross the border between two
+	 * clusters there is a transition between an entrance node on either side of the border, and
+	 * every cluster knows the shortest distance between each pair of its entrance nodes when
+	 * staying inside the cluster. Nodes are identified by the index (y * width + x) of their cell.
+	 *
+	 * Only the clusters with cells that changed since the previous synchronisation and their
+	 * neighbours are recomputed.
+	 */
+	class ClusterGraph
+	{
+		public:
+			/**
+			 * A neighbour of a node and the cost to get there
+			 */
+			typedef std::pair< unsigned int, double > Edge;
+			/**
+			 *
+			 */
+			struct Cluster
+			{
+					int minX;
+					int minY;
+					int maxX;
+					int maxY;
+					/**
+					 * The entrance nodes, sorted
+					 */
+					std::vector< unsigned int > nodes;
+					/**
+					 * nodes.size() x nodes.size() distances inside the cluster, infinite if there
+					 * is no route inside the cluster
+					 */
+					std::vector< double > distances;
+			};
+			// struct Cluster
+			/**
+			 *
+			 */
+			explicit ClusterGraph( int aClusterSize);
+			/**
+			 * Brings the graph in line with anOccupancyGrid, extended to aWidth x aHeight cells
+			 */
+			void synchronise(	const OccupancyGridPtr& anOccupancyGrid,
+								int aWidth,
+								int aHeight);
+			/**
+			 *
+			 */
+			int getClusterSize() const
+			{
+				return clusterSize;
+			}
+			/**
+			 *
+			 */
+			unsigned int getClusterIndex(	int anX,
+											int anY) const
+			{
+				return static_cast< unsigned int >((anY / clusterSize) * clustersX + anX / clusterSize);
+			}
+			/**
+			 *
+			 */
+			const Cluster& getCluster( unsigned int aClusterIndex) const
+			{
+				return clusters[aClusterIndex];
+			}
+			/**
+			 *
+			 */
+			bool isNode( unsigned int aCell) const
+			{
+				return nodes.find( aCell) != nodes.end();
+			}
+			/**
+			 * Adds the neighbours of the node aCell in the abstract graph to anEdges
+			 */
+			void getEdges(	unsigned int aCell,
+							std::vector< Edge >& anEdges) const;
+			/**
+			 * Dijkstra from aCell, which need not be free, inside aCluster. The distances of the cells
+			 * of the cluster are returned in aDistances, the predecessors in aParents (both indexed
+			 * relative to the cluster). Stops as soon as aTarget is reached if it is given.
+			 */
+			void searchCluster(	const Cluster& aCluster,
+								unsigned int aCell,
+								std::vector< double >& aDistances,
+								std::vector< unsigned int >& aParents,
+								unsigned int aTarget = static_cast< unsigned int >(-1)) const;
+			/**
+			 * @return the number of clusters whose distances were computed by the last synchronisation
+			 */
+			unsigned long getRecomputedCount() const
+			{
+				return recomputedCount;
+			}
+
+		private:
+			/**
+			 * A pair of cells on either side of a cluster border that can be crossed directly
+			 */
+			struct Transition
+			{
+					unsigned int cell1;
+					unsigned int cell2;
+					double cost;
+			};
+			// struct Transition
+			/**
+			 *
+			 */
+			bool isFree(	int anX,
+							int anY) const
+			{
+				return !blocked[static_cast< std::size_t >(anY * width + anX)];
+			}
+			/**
+			 *
+			 */
+			unsigned int cellOf(	int anX,
+									int anY) const
+			{
+				return static_cast< unsigned int >(anY * width + anX);
+			}
+			/**
+			 * The border between cluster (aClusterX,aClusterY) and its right neighbour
+			 */
+			void computeVerticalBorder(	int aClusterX,
+										int aClusterY);
+			/**
+			 * The border between cluster (aClusterX,aClusterY) and its lower neighbour
+			 */
+			void computeHorizontalBorder(	int aClusterX,
+											int aClusterY);
+			/**
+			 * The diagonal crossings at the lower right corner of cluster (aClusterX,aClusterY) that
+			 * cannot be made through one of the borders
+			 */
+			void computeCorner(	int aClusterX,
+								int aClusterY);
+			/**
+			 * Adds the transitions of the run [aFirst,aLast] of cells that can be crossed straight
+			 * over the border after column (if aVertical) or row aBorder
+			 */
+			void addRun(	std::vector< Transition >& aTransitions,
+							int aFirst,
+							int aLast,
+							int aBorder,
+							bool aVertical) const;
+			/**
+			 * Collects the entrance nodes of the cluster from its borders
+			 *
+			 * @return true if they changed
+			 */
+			bool computeNodes(	int aClusterX,
+								int aClusterY);
+			/**
+			 *
+			 */
+			void computeDistances( Cluster& aCluster);
+			/**
+			 * Rebuilds the transitions of the nodes
+			 */
+			void indexNodes();
+
+			int clusterSize;
+			int width;
+			int height;
+			int clustersX;
+			int clustersY;
+			unsigned long wallRevision;
+			unsigned long recomputedCount;
+
+			std::vector< bool > blocked;
+			std::vector< Cluster > clusters;
+			std::vector< std::vector< Transition > > verticalBorders;
+			std::vector< std::vector< Transition > > horizontalBorders;
+			std::vector< std::vector< Transition > > corners;
+			std::unordered_map< unsigned int, std::vector< Edge > > nodes;
+	}; // class ClusterGraph
+} // namespace PathAlgorithm
+#endif // CLUSTERGRAPH_HPP_
@@ -0,0 +1,193 @@
+#include "CompactPath.hpp"
+#include "AStar.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace PathAlgorithm
+{
+	/**
+	 *
+	 */
+	Vertex CompactPath::const_iterator::operator*() const
+	{
+		return path->vertexAt( index, run);
+	}
+	/**
+	 *
+	 */
+	Vertex CompactPath::const_iterator::operator[]( difference_type anOffset) const
+	{
+		return *(*this + anOffset);
+	}
+	/**
+	 *
+	 */
+	CompactPath::const_iterator& CompactPath::const_iterator::operator+=( difference_type anOffset)
+	{
+		index = static_cast< std::size_t >(static_cast< difference_type >(index) + anOffset);
+
+		// Walking through a run needs no search
+		const std::vector< Run >& runs = path->runs;
+		if (run >= runs.size() || index <= runs[run].first || index > runs[run].first + runs[run].count)
+		{
+			run = path->findRun( index);
+		}
+		return *this;
+	}
+	/**
+	 *
+	 */
+	CompactPath::CompactPath() :
+								startX( 0),
+								startY( 0),
+								startCost( 0.0),
+								vertexCount( 0)
+	{
+	}
+	/**
+	 *
+	 */
+	CompactPath::CompactPath( const Path& aPath) :
+								startX( 0),
+								startY( 0),
+								startCost( 0.0),
+								vertexCount( 0)
+	{
+		for (const Vertex& vertex : aPath)
+		{
+			push_back( vertex);
+		}
+	}
+	/**
+	 *
+	 */
+	void CompactPath::push_back( const Vertex& aVertex)
+	{
+		if (vertexCount == 0)
+		{
+			startX = aVertex.x;
+			startY = aVertex.y;
+			startCost = aVertex.actualCost;
+			vertexCount = 1;
+			return;
+		}
+		Vertex last = back();
+		addRun( aVertex.x - last.x, aVertex.y - last.y, 1);
+	}
+	/**
+	 *
+	 */
+	void CompactPath::addRun(	int aStepX,
+								int aStepY,
+								unsigned int aCount)
+	{
+		if (aCount == 0)
+		{
+			return;
+		}
+		if (!runs.empty() && runs.back().stepX == aStepX && runs.back().stepY == aStepY)
+		{
+			runs.back().count += aCount;
+		} else
+		{
+			Vertex last = back();
+			runs.push_back( Run { last.x, last.y, aStepX, aStepY, aCount, vertexCount - 1, last.actualCost });
+		}
+		vertexCount += aCount;
+	}
+	/**
+	 *
+	 */
+	void CompactPath::clear()
+	{
+		runs.clear();
+		vertexCount = 0;
+	}
+	/**
+	 *
+	 */
+	Vertex CompactPath::operator[]( std::size_t anIndex) const
+	{
+		return vertexAt( anIndex, findRun( anIndex));
+	}
+	/**
+	 *
+	 */
+	Vertex CompactPath::front() const
+	{
+		return vertexAt( 0, 0);
+	}
+	/**
+	 *
+	 */
+	Vertex CompactPath::back() const
+	{
+		return runs.empty() ? front() : vertexAt( vertexCount - 1, runs.size() - 1);
+	}
+	/**
+	 *
+	 */
+	Path CompactPath::getWaypoints() const
+	{
+		Path waypoints;
+		if (vertexCount != 0)
+		{
+			waypoints.reserve( runs.size() + 1);
+			waypoints.push_back( front());
+			for (std::size_t run = 1; run < runs.size(); ++run)
+			{
+				waypoints.push_back( vertexAt( runs[run].first, run - 1));
+			}
+			if (!runs.empty())
+			{
+				waypoints.push_back( back());
+			}
+		}
+		return waypoints;
+	}
+	/**
+	 *
+	 */
+	Path CompactPath::expand() const
+	{
+		// The iterators are random access, so the vector is allocated once
+		return Path( begin(), end());
+	}
+	/**
+	 *
+	 */
+	std::size_t CompactPath::findRun( std::size_t anIndex) const
+	{
+		if (anIndex == 0 || anIndex >= vertexCount)
+		{
+			return 0;
+		}
+		// The last run that starts before anIndex
+		std::vector< Run >::const_iterator i = std::upper_bound(	runs.begin(),
+																	runs.end(),
+																	anIndex - 1,
+																	[](std::size_t aValue, const Run& aRun)
+																	{
+																		return aValue < aRun.first;
+																	});
+		return static_cast< std::size_t >(std::distance( runs.begin(), i)) - 1;
+	}
+	/**
+	 *
+	 */
+	Vertex CompactPath::vertexAt(	std::size_t anIndex,
+									std::size_t aRun) const
+	{
+		if (anIndex == 0)
+		{
+			Vertex vertex( startX, startY);
+			vertex.actualCost = vertex.heuristicCost = startCost;
+			return vertex;
+		}
+		const Run& run = runs[aRun];
+		int step = static_cast< int >(anIndex - run.first);
+		Vertex vertex( run.x + step * run.stepX, run.y + step * run.stepY);
+		vertex.actualCost = vertex.heuristicCost = run.actualCost + step * std::sqrt( static_cast< double >(run.stepX * run.stepX + run.stepY * run.stepY));
+		return vertex;
+	}
+} // namespace PathAlgorithm
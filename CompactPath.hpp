@@ -0,0 +1,302 @@
+#ifndef COMPACTPATH_HPP_
+#define COMPACTPATH_HPP_
+
+#include "Config.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+namespace PathAlgorithm
+{
+	struct Vertex;
+	typedef std::vector< Vertex > Path;
+
+	/**
+	 * A route stored as run-length direction codes: the first vertex and runs of equal steps.
+	 * A straight stretch of an 8-connected route is one run however long it is, and the first
+	 * vertices of the runs are exactly the key waypoints of the route. The segments of an
+	 * any-angle route (see ThetaStar) are runs of a single step.
+	 *
+	 * The vertices are expanded lazily: operator[] and the random access const_iterator compute
+	 * a vertex from its run. The actual cost of a vertex is the length of the route up to it,
+	 * counted from the actual cost of the first vertex.
+	 */
+	class CompactPath
+	{
+		public:
+			/**
+			 * The vertices of a run are (x + i * stepX, y + i * stepY) for i in [1,count], the
+			 * vertex at (x,y) belongs to the previous run
+			 */
+			struct Run
+			{
+					int x;
+					int y;
+					int stepX;
+					int stepY;
+					unsigned int count;
+					/**
+					 * The index of the vertex at (x,y)
+					 */
+					std::size_t first;
+					/**
+					 * The actual cost of the vertex at (x,y)
+					 */
+					double actualCost;
+			};
+			// struct Run
+
+			/**
+			 * Expands the vertices of a CompactPath on the fly, a run is only looked up again
+			 * when the iterator leaves it
+			 */
+			class const_iterator
+			{
+				public:
+					typedef std::random_access_iterator_tag iterator_category;
+					typedef Vertex value_type;
+					typedef std::ptrdiff_t difference_type;
+					typedef const Vertex* pointer;
+					typedef Vertex reference;
+					/**
+					 *
+					 */
+					const_iterator() :
+									path( nullptr),
+									index( 0),
+									run( 0)
+					{
+					}
+					/**
+					 *
+					 */
+					const_iterator(	const CompactPath* aPath,
+									std::size_t anIndex) :
+										path( aPath),
+										index( anIndex),
+										run( aPath->findRun( anIndex))
+					{
+					}
+					/**
+					 *
+					 */
+					Vertex operator*() const;
+					/**
+					 *
+					 */
+					Vertex operator[]( difference_type anOffset) const;
+					/**
+					 *
+					 */
+					const_iterator& operator++()
+					{
+						return *this += 1;
+					}
+					/**
+					 *
+					 */
+					const_iterator operator++( int)
+					{
+						const_iterator result( *this);
+						*this += 1;
+						return result;
+					}
+					/**
+					 *
+					 */
+					const_iterator& operator--()
+					{
+						return *this -= 1;
+					}
+					/**
+					 *
+					 */
+					const_iterator operator--( int)
+					{
+						const_iterator result( *this);
+						*this -= 1;
+						return result;
+					}
+					/**
+					 *
+					 */
+					const_iterator& operator+=( difference_type anOffset);
+					/**
+					 *
+					 */
+					const_iterator& operator-=( difference_type anOffset)
+					{
+						return *this += -anOffset;
+					}
+					/**
+					 *
+					 */
+					const_iterator operator+( difference_type anOffset) const
+					{
+						const_iterator result( *this);
+						return result += anOffset;
+					}
+					/**
+					 *
+					 */
+					const_iterator operator-( difference_type anOffset) const
+					{
+						const_iterator result( *this);
+						return result -= anOffset;
+					}
+					/**
+					 *
+					 */
+					difference_type operator-( const const_iterator& anIterator) const
+					{
+						return static_cast< difference_type >(index) - static_cast< difference_type >(anIterator.index);
+					}
+					/**
+					 *
+					 */
+					bool operator==( const const_iterator& anIterator) const
+					{
+						return index == anIterator.index;
+					}
+					/**
+					 *
+					 */
+					bool operator!=( const const_iterator& anIterator) const
+					{
+						return index != anIterator.index;
+					}
+					/**
+					 *
+					 */
+					bool operator<( const const_iterator& anIterator) const
+					{
+						return index < anIterator.index;
+					}
+					/**
+					 *
+					 */
+					bool operator>( const const_iterator& anIterator) const
+					{
+						return index > anIterator.index;
+					}
+					/**
+					 *
+					 */
+					bool operator<=( const const_iterator& anIterator) const
+					{
+						return index <= anIterator.index;
+					}
+					/**
+					 *
+					 */
+					bool operator>=( const const_iterator& anIterator) const
+					{
+						return index >= anIterator.index;
+					}
+
+				private:
+					const CompactPath* path;
+					std::size_t index;
+					std::size_t run;
+			};
+			// class const_iterator
+			typedef const_iterator iterator;
+
+			/**
+			 *
+			 */
+			CompactPath();
+			/**
+			 * Compresses aPath
+			 */
+			explicit CompactPath( const Path& aPath);
+			/**
+			 * Appends aVertex, merged into the last run if it is the same step again
+			 */
+			void push_back( const Vertex& aVertex);
+			/**
+			 * Appends aCount steps of (aStepX,aStepY), the path must not be empty
+			 */
+			void addRun(	int aStepX,
+							int aStepY,
+							unsigned int aCount);
+			/**
+			 *
+			 */
+			void clear();
+			/**
+			 * @return the number of vertices
+			 */
+			std::size_t size() const
+			{
+				return vertexCount;
+			}
+			/**
+			 *
+			 */
+			bool empty() const
+			{
+				return vertexCount == 0;
+			}
+			/**
+			 * @return the vertex anIndex, computed from its run in O(log runs)
+			 */
+			Vertex operator[]( std::size_t anIndex) const;
+			/**
+			 *
+			 */
+			Vertex front() const;
+			/**
+			 *
+			 */
+			Vertex back() const;
+			/**
+			 *
+			 */
+			const_iterator begin() const
+			{
+				return const_iterator( this, 0);
+			}
+			/**
+			 *
+			 */
+			const_iterator end() const
+			{
+				return const_iterator( this, vertexCount);
+			}
+			/**
+			 *
+			 */
+			const std::vector< Run >& getRuns() const
+			{
+				return runs;
+			}
+			/**
+			 * @return the first vertex of every run and the last vertex
+			 */
+			Path getWaypoints() const;
+			/**
+			 * @return all vertices
+			 */
+			Path expand() const;
+
+		private:
+			/**
+			 * @return the run that holds the vertex anIndex, 0 for the first vertex and for end()
+			 */
+			std::size_t findRun( std::size_t anIndex) const;
+			/**
+			 * @return the vertex anIndex, which is in aRun
+			 */
+			Vertex vertexAt(	std::size_t anIndex,
+								std::size_t aRun) const;
+
+			int startX;
+			int startY;
+			double startCost;
+			std::size_t vertexCount;
+			std::vector< Run > runs;
+	}; // class CompactPath
+} // namespace PathAlgorithm
+#endif // COMPACTPATH_HPP_
@@ -0,0 +1,222 @@
+#include "CooperativeAStar.hpp"
+#include "FlowField.hpp"
+#include "OccupancyGrid.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+
+namespace PathAlgorithm
+{
+	namespace
+	{
+		/**
+		 * A vertex in space-time, the tick is the floor of the actual cost
+		 */
+		struct Node
+		{
+				int x;
+				int y;
+				double actualCost;
+				int parent;
+		};
+		// struct Node
+
+		const int xOffset[] = { 0, 1, 1, 1, 0, -1, -1, -1, 0 };
+		const int yOffset[] = { 1, 1, 0, -1, -1, -1, 0, 1, 0 };
+		/**
+		 * The last offset is a wait
+		 */
+		const int Wait = 8;
+		/**
+		 * Waiting for a robot in a corridor makes an unweighted search expand every cell it could
+		 * reach in the meantime, at every tick
+		 */
+		const double HeuristicWeight = 1.5;
+		/**
+		 * The lowest cost of a vertex that has been expanded
+		 */
+		const double Expanded = -1.0;
+
+		/**
+		 * The cell and the tick: a wait reaches the same cell a tick later, which is a vertex of
+		 * its own
+		 */
+		std::uint64_t KeyOf(	int anX,
+								int anY,
+								int aWidth,
+								double anActualCost)
+		{
+			return (static_cast< std::uint64_t >(anY * aWidth + anX) << 32) | static_cast< std::uint32_t >(anActualCost);
+		}
+		/**
+		 * The route to aNode
+		 */
+		Path ConstructPath(	const std::vector< Node >& aNodes,
+							int aNode)
+		{
+			Path path;
+			for (int i = aNode; i != -1; i = aNodes[static_cast< std::size_t >(i)].parent)
+			{
+				Vertex vertex( aNodes[static_cast< std::size_t >(i)].x, aNodes[static_cast< std::size_t >(i)].y);
+				vertex.actualCost = vertex.heuristicCost = aNodes[static_cast< std::size_t >(i)].actualCost;
+				path.push_back( vertex);
+			}
+			std::reverse( path.begin(), path.end());
+			return path;
+		}
+		/**
+		 * Appends the route of aFlowField from the last vertex of aPath
+		 */
+		void AppendFlow(	Path& aPath,
+							const FlowField& aFlowField)
+		{
+			Path tail = aFlowField.getPath( aPath.back().asPoint());
+			double offset = aPath.back().actualCost;
+			for (std::size_t i = 1; i < tail.size(); ++i)
+			{
+				tail[i].actualCost = tail[i].heuristicCost = tail[i].actualCost + offset;
+				aPath.push_back( tail[i]);
+			}
+		}
+	} // namespace
+
+	/* static */ const unsigned int CooperativeAStar::DefaultWindow;
+	/* static */ const std::size_t CooperativeAStar::MaximumNodes;
+	/**
+	 *
+	 */
+	CooperativeAStar::CooperativeAStar( unsigned int aWindow /* = DefaultWindow */) :
+								window( aWindow)
+	{
+	}
+	/**
+	 *
+	 */
+	Path CooperativeAStar::search(	Vertex aStart,
+									const Vertex& aGoal,
+									const Size& aRobotSize)
+	{
+		int radius = FreeRadius( aRobotSize);
+		FlowFieldPtr flowField = FlowField::getFlowField( aGoal.asPoint(), radius);
+		if (!flowField->contains( aStart.x, aStart.y))
+		{
+			Path path = AStar::search( aStart, aGoal, aRobotSize);
+			if (reservationTable)
+			{
+				reservationTable->reserve( path, radius);
+			}
+			return path;
+		}
+		if (!reservationTable)
+		{
+			Path path = flowField->getPath( aStart.asPoint());
+			if (path.empty())
+			{
+				std::cerr << "**** No route from " << aStart << " to " << aGoal << std::endl;
+			}
+			return path;
+		}
+		if (flowField->getPath( aStart.asPoint()).empty())
+		{
+			std::cerr << "**** No route from " << aStart << " to " << aGoal << std::endl;
+			return Path();
+		}
+
+		OccupancyGridPtr occupancyGrid = OccupancyGrid::getOccupancyGrid( radius);
+		const ReservationTable& reservations = *reservationTable;
+
+		std::vector< Node > nodes;
+		std::priority_queue< OpenEntry< int >, std::vector< OpenEntry< int > >, OpenEntryGreater > openSet;
+		// Per vertex the lowest actual cost it was generated with, or Expanded. The vertices of a
+		// cell share the heuristic, so of a vertex generated twice the cheaper one is expanded
+		// first and the other would be skipped: it is not generated at all.
+		std::unordered_map< std::uint64_t, double > lowestCosts;
+		int width = std::max( occupancyGrid->getWidth(), std::max( aStart.x, aGoal.x) + 1);
+
+		nodes.push_back( Node { aStart.x, aStart.y, 0.0, -1 });
+		openSet.push( OpenEntry< int > { 0.0, 0.0, 0 });
+
+		Path path;
+		while (!openSet.empty())
+		{
+			int currentNode = openSet.top().index;
+			openSet.pop();
+			Node current = nodes[static_cast< std::size_t >(currentNode)];
+			double& lowestCost = lowestCosts[KeyOf( current.x, current.y, width, current.actualCost)];
+			if (lowestCost == Expanded)
+			{
+				continue;
+			}
+			lowestCost = Expanded;
+			publishProgress();
+
+			unsigned int tick = static_cast< unsigned int >(current.actualCost);
+			if (current.x == aGoal.x && current.y == aGoal.y && reservations.isFreeFrom( current.x, current.y, radius, tick))
+			{
+				path = ConstructPath( nodes, currentNode);
+				break;
+			}
+			if (tick >= window || nodes.size() + Wait >= MaximumNodes)
+			{
+				// The flow field does the rest
+				path = ConstructPath( nodes, currentNode);
+				AppendFlow( path, *flowField);
+				break;
+			}
+
+			OccupancyGrid::countWallChecks( Wait);
+			for (int d = 0; d <= Wait; ++d)
+			{
+				int x = current.x + xOffset[d];
+				int y = current.y + yOffset[d];
+				double heuristicCost = flowField->getCost( x, y);
+				if (d != Wait && (!occupancyGrid->isFree( x, y) || std::isinf( heuristicCost)))
+				{
+					continue;
+				}
+				if (std::isinf( heuristicCost))
+				{
+					// Waiting on an occupied start
+					heuristicCost = 0.0;
+				}
+				double actualCost = current.actualCost + (d == Wait ? 1.0 : (xOffset[d] != 0 && yOffset[d] != 0 ? DiagonalStepCost : 1.0));
+
+				// The ticks of the step, at which the robot may still be on either cell
+				bool free = true;
+				for (unsigned int t = tick + 1; free && t <= static_cast< unsigned int >(actualCost); ++t)
+				{
+					free = reservations.isFree( x, y, radius, t) && (d == Wait || reservations.isFree( current.x, current.y, radius, t));
+				}
+				if (!free)
+				{
+					continue;
+				}
+				// Expanded is below any actual cost
+				std::pair< std::unordered_map< std::uint64_t, double >::iterator, bool > lowest = lowestCosts.insert( std::make_pair( KeyOf( x, y, width, actualCost), actualCost));
+				if (!lowest.second)
+				{
+					if (lowest.first->second <= actualCost)
+					{
+						continue;
+					}
+					lowest.first->second = actualCost;
+				}
+
+				nodes.push_back( Node { x, y, actualCost, currentNode });
+				openSet.push( OpenEntry< int > { actualCost + HeuristicWeight * heuristicCost, actualCost, static_cast< int >(nodes.size() - 1) });
+				countGenerated( openSet.size());
+			}
+		}
+
+		if (path.empty())
+		{
+			std::cerr << "**** No route from " << aStart << " to " << aGoal << " around the reserved robots" << std::endl;
+			return path;
+		}
+		reservationTable->reserve( path, radius);
+		return path;
+	}
+} // namespace PathAlgorithm
@@ -0,0 +1,78 @@
+#ifndef COOPERATIVEASTAR_HPP_
+#define COOPERATIVEASTAR_HPP_
+
+#include "Config.hpp"
+
+#include <cstddef>
+#include <memory>
+
+#include "AStar.hpp"
+#include "ReservationTable.hpp"
+
+namespace PathAlgorithm
+{
+	/**
+	 * Windowed Hierarchical Cooperative A* (Silver, 2005) for prioritised planning: a space-time
+	 * search over (cell, tick) that waits or steps aside for the robots already reserved in the
+	 * ReservationTable, after which the route is reserved for the robots planned after it.
+	 *
+	 * The heuristic is the true distance to the goal without the other robots, taken from the
+	 * FlowField of the goal and weighted by 1.5. A vertex is a cell at a tick, the floor of the
+	 * actual cost, so waiting a tick on a cell reaches a new vertex. Beyond the window the route
+	 * follows the flow field without looking at the reservations.
+	 *
+	 * Without a reservation table the route is the route of the flow field.
+	 */
+	class CooperativeAStar : public AStar
+	{
+		public:
+			/**
+			 * The ticks searched in space-time
+			 */
+			static const unsigned int DefaultWindow = 1024;
+			/**
+			 * A search that generated this many vertices gives up and follows the flow field. A
+			 * vertex takes up to some 100 bytes in the nodes, the openSet and the lowest costs, so
+			 * a search stays around 100 MB at most, however long the window.
+			 */
+			static const std::size_t MaximumNodes = 1000000;
+			/**
+			 *
+			 */
+			explicit CooperativeAStar( unsigned int aWindow = DefaultWindow);
+			using AStar::search;
+			/**
+			 *
+			 */
+			virtual Path search(Vertex aStart,
+								const Vertex& aGoal,
+								const Size& aRobotSize);
+			/**
+			 * The routes depend on the reservations
+			 */
+			virtual bool isCacheable() const
+			{
+				return false;
+			}
+			/**
+			 * The routes found from now on avoid the reservations of aReservationTable and are
+			 * reserved in it, nullptr to plan without
+			 */
+			void setReservationTable( const std::shared_ptr< ReservationTable >& aReservationTable)
+			{
+				reservationTable = aReservationTable;
+			}
+			/**
+			 *
+			 */
+			const std::shared_ptr< ReservationTable >& getReservationTable() const
+			{
+				return reservationTable;
+			}
+
+		private:
+			unsigned int window;
+			std::shared_ptr< ReservationTable > reservationTable;
+	}; // class CooperativeAStar
+} // namespace PathAlgorithm
+#endif // COOPERATIVEASTAR_HPP_
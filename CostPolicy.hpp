@@ -0,0 +1,61 @@
+#ifndef COSTPOLICY_HPP_
+#define COSTPOLICY_HPP_
+
+#include "Config.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace PathAlgorithm
+{
+	/**
+	 * Fixed-point costs on the 8-connected grid: a straight step costs aStraightCost, a diagonal
+	 * step aDiagonalCost and the heuristic is the octile distance in the same units. The octile
+	 * distance is the exact cost of the route if there are no walls, so it is both admissible and
+	 * consistent and the routes are optimal under the octile metric.
+	 *
+	 * The default 408/577 is a convergent of sqrt(2) that is off by less than 2e-6, 5/7 is the
+	 * coarse classic that keeps the costs small.
+	 */
+	template< unsigned int aStraightCost = 408, unsigned int aDiagonalCost = 577 >
+	struct OctileCost
+	{
+			typedef unsigned long CostType;
+
+			static const CostType StraightCost = aStraightCost;
+			static const CostType DiagonalCost = aDiagonalCost;
+			/**
+			 * The largest cost of a single step
+			 */
+			static const CostType MaximumStepCost = aDiagonalCost;
+			/**
+			 * The cost of a step of aDX,aDY in [-1,1] x [-1,1]
+			 */
+			static CostType stepCost(	int aDX,
+										int aDY)
+			{
+				return aDX != 0 && aDY != 0 ? DiagonalCost : StraightCost;
+			}
+			/**
+			 *
+			 */
+			static CostType heuristicCost(	int anX,
+											int anY,
+											int aGoalX,
+											int aGoalY)
+			{
+				CostType dx = static_cast< CostType >(std::abs( anX - aGoalX));
+				CostType dy = static_cast< CostType >(std::abs( anY - aGoalY));
+				return StraightCost * std::max( dx, dy) + (DiagonalCost - StraightCost) * std::min( dx, dy);
+			}
+			/**
+			 * Converts aCost back into cells, as used by ActualCost
+			 */
+			static double toCells( CostType aCost)
+			{
+				return static_cast< double >(aCost) / static_cast< double >(StraightCost);
+			}
+	};
+	// struct OctileCost
+} // namespace PathAlgorithm
+#endif // COSTPOLICY_HPP_
@@ -0,0 +1,400 @@
+#include "DStarLite.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+namespace PathAlgorithm
+{
+	namespace
+	{
+		const double Infinity = std::numeric_limits< double >::infinity();
+		const double DiagonalCost = std::sqrt( 2.0);
+		/**
+		 * Compares the keys of the openSet entries like VertexLessCostCompare but treats first keys
+		 * that only differ by rounding errors as equal: a vertex on a straight line towards the
+		 * start has the same first key as the start and must be expanded before the start.
+		 */
+		bool KeyLess(	const Vertex& lhs,
+						const Vertex& rhs)
+		{
+			const double epsilon = 1e-6;
+			if (lhs.heuristicCost < rhs.heuristicCost - epsilon)
+				return true;
+			if (lhs.heuristicCost <= rhs.heuristicCost + epsilon)
+				return lhs.actualCost > rhs.actualCost;
+			return false;
+		}
+	}
+	/**
+	 *
+	 */
+	DStarLite::DStarLite() :
+								initialised( false),
+								radius( 0),
+								width( 0),
+								height( 0),
+								wallRevision( 0),
+								start( 0, 0),
+								lastStart( 0, 0),
+								goal( 0, 0),
+								keyModifier( 0.0),
+								expandedCount( 0)
+	{
+	}
+	/**
+	 *
+	 */
+	Path DStarLite::search(	Vertex aStart,
+							const Vertex& aGoal,
+							const Size& aRobotSize)
+	{
+		int freeRadius = FreeRadius( aRobotSize);
+		occupancyGrid = OccupancyGrid::getOccupancyGrid( freeRadius);
+
+		Size bounds = WorldBounds( aStart, aGoal, *occupancyGrid);
+		if (aStart.x < 0 || aStart.y < 0 || aGoal.x < 0 || aGoal.y < 0)
+		{
+			std::cerr << "**** No route from " << aStart << " to " << aGoal << ": outside of the world" << std::endl;
+			return Path();
+		}
+
+		expandedCount = 0;
+		if (!initialised || !aGoal.equalPoint( goal) || freeRadius != radius || bounds.x != width || bounds.y != height)
+		{
+			initialise( aStart, aGoal, freeRadius, bounds);
+		} else
+		{
+			// The keys in the openSet are relative to the previous start
+			keyModifier += HeuristicCost( lastStart, aStart);
+			lastStart = aStart;
+			start = aStart;
+			updateBlockedCells();
+		}
+
+		computeShortestPath();
+
+		if (g[static_cast< std::size_t >(start.y * width + start.x)] == Infinity)
+		{
+			std::cerr << "**** No route from " << aStart << " to " << aGoal << std::endl;
+			return Path();
+		}
+		return constructPath();
+	}
+	/**
+	 *
+	 */
+	std::size_t DStarLite::getAllocatedBytes() const
+	{
+		return AStar::getAllocatedBytes() + (g.capacity() + rhs.capacity()) * sizeof( double) + blocked.capacity() / 8;
+	}
+	/**
+	 *
+	 */
+	void DStarLite::addBlockedArea(	const Point& aCentre,
+									int aRadius)
+	{
+		blockedAreas.push_back( BlockedArea( aCentre, aRadius));
+	}
+	/**
+	 *
+	 */
+	void DStarLite::clearBlockedAreas()
+	{
+		blockedAreas.clear();
+	}
+	/**
+	 *
+	 */
+	void DStarLite::reset()
+	{
+		initialised = false;
+		getOS().clear();
+	}
+	/**
+	 *
+	 */
+	void DStarLite::initialise(	const Vertex& aStart,
+								const Vertex& aGoal,
+								int aRadius,
+								const Size& aBounds)
+	{
+		radius = aRadius;
+		width = aBounds.x;
+		height = aBounds.y;
+		wallRevision = occupancyGrid->getWallRevision();
+
+		start = aStart;
+		lastStart = aStart;
+		goal = aGoal;
+		keyModifier = 0.0;
+
+		std::size_t size = static_cast< std::size_t >(width) * static_cast< std::size_t >(height);
+		g.assign( size, Infinity);
+		rhs.assign( size, Infinity);
+		blocked.assign( size, false);
+		OccupancyGrid::countWallChecks( size);
+		for (int y = 0; y < height; ++y)
+		{
+			for (int x = 0; x < width; ++x)
+			{
+				blocked[static_cast< std::size_t >(y * width + x)] = isBlocked( x, y);
+			}
+		}
+		appliedBlockedAreas = blockedAreas;
+
+		getOS().clear();
+
+		unsigned int goalIndex = static_cast< unsigned int >(goal.y * width + goal.x);
+		rhs[goalIndex] = 0.0;
+		addToOpenSet( calculateKey( goalIndex));
+
+		initialised = true;
+	}
+	/**
+	 *
+	 */
+	void DStarLite::updateBlockedCells()
+	{
+		if (occupancyGrid->getWallRevision() != wallRevision)
+		{
+			// Any cell may have changed
+			updateBlockedCells( 0, 0, width - 1, height - 1);
+			wallRevision = occupancyGrid->getWallRevision();
+		} else
+		{
+			// Only the cells of the blocked areas may have changed
+			for (const std::vector< BlockedArea >* areas : { &appliedBlockedAreas, &blockedAreas })
+			{
+				for (const BlockedArea& area : *areas)
+				{
+					updateBlockedCells( area.centre.x - area.radius, area.centre.y - area.radius, area.centre.x + area.radius, area.centre.y + area.radius);
+				}
+			}
+		}
+		appliedBlockedAreas = blockedAreas;
+	}
+	/**
+	 *
+	 */
+	void DStarLite::updateBlockedCells(	int aMinX,
+										int aMinY,
+										int aMaxX,
+										int aMaxY)
+	{
+		aMinX = std::max( aMinX, 0);
+		aMinY = std::max( aMinY, 0);
+		aMaxX = std::min( aMaxX, width - 1);
+		aMaxY = std::min( aMaxY, height - 1);
+		if (aMaxX >= aMinX && aMaxY >= aMinY)
+		{
+			OccupancyGrid::countWallChecks( static_cast< unsigned long >(aMaxX - aMinX + 1) * static_cast< unsigned long >(aMaxY - aMinY + 1));
+		}
+
+		for (int y = aMinY; y <= aMaxY; ++y)
+		{
+			for (int x = aMinX; x <= aMaxX; ++x)
+			{
+				unsigned int index = static_cast< unsigned int >(y * width + x);
+				bool isNowBlocked = isBlocked( x, y);
+				if (blocked[index] != isNowBlocked)
+				{
+					blocked[index] = isNowBlocked;
+
+					// Only the edges into the cell changed
+					unsigned int neighbours[8];
+					int numberOfNeighbours = getNeighbours( index, neighbours);
+					for (int i = 0; i < numberOfNeighbours; ++i)
+					{
+						updateVertex( neighbours[i]);
+					}
+				}
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	bool DStarLite::isBlocked(	int anX,
+								int anY) const
+	{
+		if (!occupancyGrid->isFree( anX, anY))
+		{
+			return true;
+		}
+		for (const BlockedArea& area : blockedAreas)
+		{
+			if (area.contains( anX, anY))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+	/**
+	 *
+	 */
+	double DStarLite::getCost(	unsigned int anIndex,
+								unsigned int aNeighbourIndex) const
+	{
+		if (blocked[aNeighbourIndex])
+		{
+			return Infinity;
+		}
+		unsigned int difference = anIndex > aNeighbourIndex ? anIndex - aNeighbourIndex : aNeighbourIndex - anIndex;
+		return difference == 1 || difference == static_cast< unsigned int >(width) ? 1.0 : DiagonalCost;
+	}
+	/**
+	 *
+	 */
+	Vertex DStarLite::calculateKey( unsigned int anIndex) const
+	{
+		Vertex vertex( static_cast< int >(anIndex % static_cast< unsigned int >(width)), static_cast< int >(anIndex / static_cast< unsigned int >(width)));
+		double cost = std::min( g[anIndex], rhs[anIndex]);
+		vertex.heuristicCost = cost + HeuristicCost( start, vertex) + keyModifier;
+		vertex.actualCost = -cost;
+		return vertex;
+	}
+	/**
+	 *
+	 */
+	void DStarLite::updateVertex( unsigned int anIndex)
+	{
+		if (anIndex != static_cast< unsigned int >(goal.y * width + goal.x))
+		{
+			double cost = Infinity;
+			unsigned int neighbours[8];
+			int numberOfNeighbours = getNeighbours( anIndex, neighbours);
+			for (int i = 0; i < numberOfNeighbours; ++i)
+			{
+				cost = std::min( cost, getCost( anIndex, neighbours[i]) + g[neighbours[i]]);
+			}
+			rhs[anIndex] = cost;
+		}
+
+		if (g[anIndex] != rhs[anIndex])
+		{
+			addToOpenSet( calculateKey( anIndex));
+		} else
+		{
+			findRemoveInOpenSet( Vertex( static_cast< int >(anIndex % static_cast< unsigned int >(width)), static_cast< int >(anIndex / static_cast< unsigned int >(width))));
+		}
+	}
+	/**
+	 *
+	 */
+	void DStarLite::computeShortestPath()
+	{
+		unsigned int startIndex = static_cast< unsigned int >(start.y * width + start.x);
+
+		while (!getOS().empty())
+		{
+			Vertex top = getOS().top();
+			if (!KeyLess( top, calculateKey( startIndex)) && rhs[startIndex] == g[startIndex])
+			{
+				break;
+			}
+
+			unsigned int index = static_cast< unsigned int >(top.y * width + top.x);
+			Vertex newKey = calculateKey( index);
+			++expandedCount;
+			publishProgress();
+
+			if (top.lessCost( newKey))
+			{
+				// The key is outdated since the start moved
+				updateInOpenSet( newKey);
+				continue;
+			}
+
+			unsigned int neighbours[8];
+			int numberOfNeighbours = getNeighbours( index, neighbours);
+			if (g[index] > rhs[index])
+			{
+				g[index] = rhs[index];
+				removeFirstFromOpenSet();
+			} else
+			{
+				g[index] = Infinity;
+				updateVertex( index);
+			}
+			// A blocked cell is never on the route of its neighbours
+			if (!blocked[index])
+			{
+				for (int i = 0; i < numberOfNeighbours; ++i)
+				{
+					updateVertex( neighbours[i]);
+				}
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	Path DStarLite::constructPath() const
+	{
+		Path path;
+
+		unsigned int goalIndex = static_cast< unsigned int >(goal.y * width + goal.x);
+		unsigned int current = static_cast< unsigned int >(start.y * width + start.x);
+		double actualCost = 0.0;
+		path.push_back( Vertex( start.x, start.y));
+
+		std::size_t maximumLength = g.size();
+		while (current != goalIndex)
+		{
+			unsigned int next = current;
+			double lowestCost = Infinity;
+
+			unsigned int neighbours[8];
+			int numberOfNeighbours = getNeighbours( current, neighbours);
+			for (int i = 0; i < numberOfNeighbours; ++i)
+			{
+				double cost = getCost( current, neighbours[i]) + g[neighbours[i]];
+				if (cost < lowestCost)
+				{
+					lowestCost = cost;
+					next = neighbours[i];
+				}
+			}
+			if (lowestCost == Infinity || path.size() > maximumLength)
+			{
+				std::cerr << "**** No route from " << start << " to " << goal << std::endl;
+				return Path();
+			}
+
+			actualCost += getCost( current, next);
+			current = next;
+
+			Vertex vertex( static_cast< int >(current % static_cast< unsigned int >(width)), static_cast< int >(current / static_cast< unsigned int >(width)));
+			vertex.actualCost = actualCost;
+			vertex.heuristicCost = actualCost;
+			path.push_back( vertex);
+		}
+		return path;
+	}
+	/**
+	 *
+	 */
+	int DStarLite::getNeighbours(	unsigned int anIndex,
+									unsigned int* aNeighbours) const
+	{
+		static int xOffset[] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+		static int yOffset[] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+
+		int x = static_cast< int >(anIndex % static_cast< unsigned int >(width));
+		int y = static_cast< int >(anIndex / static_cast< unsigned int >(width));
+
+		int n = 0;
+		for (int i = 0; i < 8; ++i)
+		{
+			int neighbourX = x + xOffset[i];
+			int neighbourY = y + yOffset[i];
+			if (neighbourX >= 0 && neighbourY >= 0 && neighbourX < width && neighbourY < height)
+			{
+				aNeighbours[n++] = static_cast< unsigned int >(neighbourY * width + neighbourX);
+			}
+		}
+		return n;
+	}
+} // namespace PathAlgorithm
@@ -0,0 +1,179 @@
+#ifndef DSTARLITE_HPP_
+#define DSTARLITE_HPP_
+
+#include "Config.hpp"
+
+#include <memory>
+#include <vector>
+
+#include "AStar.hpp"
+#include "OccupancyGrid.hpp"
+
+namespace PathAlgorithm
+{
+	/**
+	 * An area of the grid that is blocked for the time being, e.g. the footprint of another robot
+	 */
+	struct BlockedArea
+	{
+			/**
+			 *
+			 */
+			BlockedArea(	const Point& aCentre,
+							int aRadius) :
+								centre( aCentre),
+								radius( aRadius)
+			{
+			}
+			/**
+			 *
+			 */
+			bool contains(	int anX,
+							int anY) const
+			{
+				return (anX - centre.x) * (anX - centre.x) + (anY - centre.y) * (anY - centre.y) < radius * radius;
+			}
+
+			Point centre;
+			int radius;
+	};
+	// struct BlockedArea
+
+	class DStarLite;
+	typedef std::shared_ptr< DStarLite > DStarLitePtr;
+
+	/**
+	 * D* Lite (Koenig and Likhachev, 2002) on the same 8-connected grid as AStar.
+	 *
+	 * The search runs from the goal to the start and its state is kept between calls. As long as
+	 * the goal and the robot size stay the same, a next search only repairs the costs of the cells
+	 * around the cells that became blocked or free since the previous search: walls that were
+	 * edited and the blocked areas that were set. A robot that only moved on along its route gets
+	 * a new route for (almost) nothing.
+	 *
+	 * The openSet holds the D* Lite priority queue: heuristicCost is the first key and actualCost
+	 * the negated second key, so VertexLessCostCompare orders the vertices on their keys.
+	 */
+	class DStarLite : public AStar
+	{
+		public:
+			using AStar::search;
+			/**
+			 *
+			 */
+			DStarLite();
+			/**
+			 * Continues the previous search if the goal and the robot size did not change,
+			 * otherwise starts all over
+			 */
+			virtual Path search(Vertex aStart,
+								const Vertex& aGoal,
+								const Size& aRobotSize);
+			/**
+			 * The routes depend on the blocked areas as well
+			 */
+			virtual bool isCacheable() const
+			{
+				return blockedAreas.empty();
+			}
+			/**
+			 *
+			 */
+			virtual std::size_t getAllocatedBytes() const;
+			/**
+			 * Blocks the cells within aRadius of aCentre for the next searches, until
+			 * clearBlockedAreas is called
+			 */
+			void addBlockedArea(	const Point& aCentre,
+									int aRadius);
+			/**
+			 *
+			 */
+			void clearBlockedAreas();
+			/**
+			 * Forgets the search state, the next search starts all over
+			 */
+			void reset();
+			/**
+			 * @return the number of vertices that were expanded by the last search
+			 */
+			unsigned long getExpandedCount() const
+			{
+				return expandedCount;
+			}
+
+		private:
+			/**
+			 *
+			 */
+			void initialise(	const Vertex& aStart,
+								const Vertex& aGoal,
+								int aRadius,
+								const Size& aBounds);
+			/**
+			 * Brings the blocked cells in line with the occupancy grid and the blocked areas and
+			 * updates the vertices whose outgoing edges changed
+			 */
+			void updateBlockedCells();
+			/**
+			 * Updates the blocked state of the cells in [aMinX,aMaxX] x [aMinY,aMaxY]
+			 */
+			void updateBlockedCells(	int aMinX,
+										int aMinY,
+										int aMaxX,
+										int aMaxY);
+			/**
+			 *
+			 */
+			bool isBlocked(	int anX,
+							int anY) const;
+			/**
+			 * @return the cost of moving from anIndex to the neighbour aNeighbourIndex
+			 */
+			double getCost(	unsigned int anIndex,
+							unsigned int aNeighbourIndex) const;
+			/**
+			 * @return the priority queue entry for anIndex
+			 */
+			Vertex calculateKey( unsigned int anIndex) const;
+			/**
+			 *
+			 */
+			void updateVertex( unsigned int anIndex);
+			/**
+			 *
+			 */
+			void computeShortestPath();
+			/**
+			 * Follows the lowest costs from the start to the goal
+			 */
+			Path constructPath() const;
+			/**
+			 * @return the number of neighbours of anIndex that are inside the grid, their indices are
+			 * returned in aNeighbours
+			 */
+			int getNeighbours(	unsigned int anIndex,
+								unsigned int* aNeighbours) const;
+
+			bool initialised;
+			OccupancyGridPtr occupancyGrid;
+			int radius;
+			int width;
+			int height;
+			unsigned long wallRevision;
+
+			Vertex start;
+			Vertex lastStart;
+			Vertex goal;
+			double keyModifier;
+			unsigned long expandedCount;
+
+			std::vector< double > g;
+			std::vector< double > rhs;
+			std::vector< bool > blocked;
+
+			std::vector< BlockedArea > blockedAreas;
+			std::vector< BlockedArea > appliedBlockedAreas;
+	}; // class DStarLite
+} // namespace PathAlgorithm
+#endif // DSTARLITE_HPP_
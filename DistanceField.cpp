@@ -0,0 +1,352 @@
+#include "DistanceField.hpp"
+#include "RobotWorld.hpp"
+#include "Shape2DUtils.hpp"
+#include "Wall.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iterator>
+#include <mutex>
+
+namespace PathAlgorithm
+{
+	/**
+	 *
+	 */
+	bool SegmentLess(	const DistanceField::Segment& lhs,
+						const DistanceField::Segment& rhs)
+	{
+		if (lhs.first.x != rhs.first.x) return lhs.first.x < rhs.first.x;
+		if (lhs.first.y != rhs.first.y) return lhs.first.y < rhs.first.y;
+		if (lhs.second.x != rhs.second.x) return lhs.second.x < rhs.second.x;
+		return lhs.second.y < rhs.second.y;
+	}
+	/**
+	 * The squared distance transform of a sampled function f of length n (Felzenszwalb and
+	 * Huttenlocher): the lower envelope of the parabolas rooted at every sample. aVertices and
+	 * aBoundaries are scratch buffers of n and n + 1 elements.
+	 */
+	void DistanceTransform(	const float* f,
+							int n,
+							float* d,
+							int* aVertices,
+							double* aBoundaries)
+	{
+		int k = 0;
+		aVertices[0] = 0;
+		aBoundaries[0] = -HUGE_VAL;
+		aBoundaries[1] = HUGE_VAL;
+		for (int q = 1; q < n; ++q)
+		{
+			// Where the parabola of q starts to lie below the lowest parabola of the envelope so far
+			double s = ((static_cast< double >(f[q]) + q * q) - (static_cast< double >(f[aVertices[k]]) + aVertices[k] * aVertices[k])) / (2.0 * (q - aVertices[k]));
+			while (s <= aBoundaries[k])
+			{
+				--k;
+				s = ((static_cast< double >(f[q]) + q * q) - (static_cast< double >(f[aVertices[k]]) + aVertices[k] * aVertices[k])) / (2.0 * (q - aVertices[k]));
+			}
+			++k;
+			aVertices[k] = q;
+			aBoundaries[k] = s;
+			aBoundaries[k + 1] = HUGE_VAL;
+		}
+
+		k = 0;
+		for (int q = 0; q < n; ++q)
+		{
+			while (aBoundaries[k + 1] < q)
+			{
+				++k;
+			}
+			int v = aVertices[k];
+			d[q] = static_cast< float >((q - v) * (q - v) + static_cast< double >(f[v]));
+		}
+	}
+	/**
+	 *
+	 */
+	DistanceField::DistanceField() :
+								width( 0),
+								height( 0),
+								wallRevision( static_cast< unsigned long >(-1)),
+								previousWallRevision( static_cast< unsigned long >(-1)),
+								changedRegion { 0, 0, -1, -1 }
+	{
+	}
+	/**
+	 *
+	 */
+	/* static */ DistanceFieldPtr DistanceField::getDistanceField()
+	{
+		static std::mutex fieldMutex;
+		static std::shared_ptr< DistanceField > field = std::make_shared< DistanceField >();
+
+		std::lock_guard< std::mutex > lock( fieldMutex);
+
+		unsigned long revision = Model::RobotWorld::getRobotWorld().getWallRevision();
+		if (field->getWallRevision() != revision)
+		{
+			// Users of the field must not see it change
+			if (field.use_count() > 1)
+			{
+				field = std::make_shared< DistanceField >( *field);
+			}
+			field->synchronise( getWallSegments(), revision);
+		}
+		return field;
+	}
+	/**
+	 *
+	 */
+	/* static */ std::vector< DistanceField::Segment > DistanceField::getWallSegments()
+	{
+		std::vector< Segment > wallSegments;
+		const std::vector< Model::WallPtr >& walls = Model::RobotWorld::getRobotWorld().getWalls();
+		wallSegments.reserve( walls.size());
+		for (const Model::WallPtr& wall : walls)
+		{
+			wallSegments.push_back( Segment( wall->getPoint1(), wall->getPoint2()));
+		}
+		return wallSegments;
+	}
+	/**
+	 *
+	 */
+	void DistanceField::synchronise(	const std::vector< Segment >& aSegments,
+										unsigned long aWallRevision)
+	{
+		std::vector< Segment > newSegments( aSegments);
+		std::sort( newSegments.begin(), newSegments.end(), SegmentLess);
+
+		int requiredWidth = 0;
+		int requiredHeight = 0;
+		for (const Segment& segment : newSegments)
+		{
+			requiredWidth = std::max( requiredWidth, std::max( segment.first.x, segment.second.x) + MaximumDistance + 1);
+			requiredHeight = std::max( requiredHeight, std::max( segment.first.y, segment.second.y) + MaximumDistance + 1);
+		}
+
+		Region dirty { 0, 0, -1, -1 };
+		if (requiredWidth > width || requiredHeight > height)
+		{
+			// The world grew: start all over
+			resize( std::max( requiredWidth, width), std::max( requiredHeight, height));
+			for (const Segment& segment : newSegments)
+			{
+				rasterise( segment, 1, dirty);
+			}
+			changedRegion = Region { 0, 0, width - 1, height - 1 };
+			transform( changedRegion, changedRegion);
+		} else
+		{
+			std::vector< Segment > removedSegments;
+			std::set_difference(	segments.begin(), segments.end(),
+									newSegments.begin(), newSegments.end(),
+									std::back_inserter( removedSegments),
+									SegmentLess);
+			std::vector< Segment > addedSegments;
+			std::set_difference(	newSegments.begin(), newSegments.end(),
+									segments.begin(), segments.end(),
+									std::back_inserter( addedSegments),
+									SegmentLess);
+			for (const Segment& segment : removedSegments)
+			{
+				rasterise( segment, -1, dirty);
+			}
+			for (const Segment& segment : addedSegments)
+			{
+				rasterise( segment, 1, dirty);
+			}
+
+			changedRegion = Region { 0, 0, -1, -1 };
+			if (dirty.maxX >= dirty.minX)
+			{
+				// A changed wall cell changes the (capped) distances within MaximumDistance of it, and
+				// those distances only depend on the walls within MaximumDistance of these cells
+				changedRegion = Region { std::max( dirty.minX - MaximumDistance, 0),
+										 std::max( dirty.minY - MaximumDistance, 0),
+										 std::min( dirty.maxX + MaximumDistance, width - 1),
+										 std::min( dirty.maxY + MaximumDistance, height - 1) };
+				Region window { std::max( dirty.minX - 2 * MaximumDistance, 0),
+								std::max( dirty.minY - 2 * MaximumDistance, 0),
+								std::min( dirty.maxX + 2 * MaximumDistance, width - 1),
+								std::min( dirty.maxY + 2 * MaximumDistance, height - 1) };
+				transform( window, changedRegion);
+			}
+		}
+
+		segments.swap( newSegments);
+		previousWallRevision = wallRevision;
+		wallRevision = aWallRevision;
+	}
+	/**
+	 *
+	 */
+	double DistanceField::castRay(	const Point& aFrom,
+									double anAngle,
+									double aMaximumRange) const
+	{
+		double dX = std::cos( anAngle);
+		double dY = std::sin( anAngle);
+
+		double travelled = 0.0;
+		for (;;)
+		{
+			double t = std::min( travelled, aMaximumRange);
+			float clearance = getDistance( static_cast< int >(std::round( aFrom.x + t * dX)), static_cast< int >(std::round( aFrom.y + t * dY)));
+			if (clearance < 1.0f)
+			{
+				return t;
+			}
+			if (t >= aMaximumRange)
+			{
+				return aMaximumRange;
+			}
+			// The point may be up to half a cell from the centre of its cell, and so may the wall
+			travelled += std::max( static_cast< double >(clearance) - 1.0, 0.5);
+		}
+	}
+	/**
+	 *
+	 */
+	bool DistanceField::intersectsWall(	const Point& aFrom,
+										const Point& aTo) const
+	{
+		// Every point of a wall is within 0.71 of a wall cell and every point of the segment within
+		// half its length and 0.71 of the cell of its centre. Beyond the field the distance to the
+		// walls is not known.
+		int centreX = (aFrom.x + aTo.x) / 2;
+		int centreY = (aFrom.y + aTo.y) / 2;
+		double length = std::sqrt( static_cast< double >((aTo.x - aFrom.x) * (aTo.x - aFrom.x) + (aTo.y - aFrom.y) * (aTo.y - aFrom.y)));
+		if (contains( centreX, centreY) && getDistance( centreX, centreY) >= length / 2.0 + 1.5)
+		{
+			return false;
+		}
+		// A trace through the cells could slip between the cells of a diagonal wall
+		for (const Segment& segment : segments)
+		{
+			if (Utils::Shape2DUtils::intersect( aFrom, aTo, segment.first, segment.second))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+	/**
+	 *
+	 */
+	DistanceField::Region DistanceField::getChangedRegion( unsigned long aWallRevision) const
+	{
+		if (aWallRevision == wallRevision)
+		{
+			return Region { 0, 0, -1, -1 };
+		}
+		if (aWallRevision == previousWallRevision)
+		{
+			return changedRegion;
+		}
+		return Region { 0, 0, width - 1, height - 1 };
+	}
+	/**
+	 *
+	 */
+	void DistanceField::rasterise(	const Segment& aSegment,
+									int aDelta,
+									Region& aDirty)
+	{
+		int x = aSegment.first.x;
+		int y = aSegment.first.y;
+		int dX = std::abs( aSegment.second.x - x);
+		int dY = -std::abs( aSegment.second.y - y);
+		int stepX = x < aSegment.second.x ? 1 : -1;
+		int stepY = y < aSegment.second.y ? 1 : -1;
+		int error = dX + dY;
+
+		// Bresenham
+		for (;;)
+		{
+			if (contains( x, y))
+			{
+				std::size_t index = static_cast< std::size_t >(y * width + x);
+				wallCount[index] = static_cast< unsigned short >(wallCount[index] + aDelta);
+				if (aDirty.maxX < aDirty.minX)
+				{
+					aDirty = Region { x, y, x, y };
+				} else
+				{
+					aDirty = Region { std::min( aDirty.minX, x), std::min( aDirty.minY, y), std::max( aDirty.maxX, x), std::max( aDirty.maxY, y) };
+				}
+			}
+			if (x == aSegment.second.x && y == aSegment.second.y)
+			{
+				break;
+			}
+			int doubleError = 2 * error;
+			if (doubleError >= dY)
+			{
+				error += dY;
+				x += stepX;
+			}
+			if (doubleError <= dX)
+			{
+				error += dX;
+				y += stepY;
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	void DistanceField::resize(	int aWidth,
+								int aHeight)
+	{
+		width = aWidth;
+		height = aHeight;
+		wallCount.assign( static_cast< std::size_t >(width) * static_cast< std::size_t >(height), 0);
+		distance.assign( wallCount.size(), static_cast< float >(MaximumDistance));
+	}
+	/**
+	 *
+	 */
+	void DistanceField::transform(	const Region& aWindow,
+									const Region& aTarget)
+	{
+		const float infinity = 1e20f;
+
+		int windowWidth = aWindow.maxX - aWindow.minX + 1;
+		int windowHeight = aWindow.maxY - aWindow.minY + 1;
+		int longest = std::max( windowWidth, windowHeight);
+
+		std::vector< float > squared( static_cast< std::size_t >(windowWidth) * static_cast< std::size_t >(windowHeight));
+		std::vector< float > f( static_cast< std::size_t >(longest));
+		std::vector< float > d( static_cast< std::size_t >(longest));
+		std::vector< int > vertices( static_cast< std::size_t >(longest));
+		std::vector< double > boundaries( static_cast< std::size_t >(longest) + 1);
+
+		// The columns, only the wall cells are at distance 0
+		for (int x = 0; x < windowWidth; ++x)
+		{
+			for (int y = 0; y < windowHeight; ++y)
+			{
+				std::size_t index = static_cast< std::size_t >((aWindow.minY + y) * width + aWindow.minX + x);
+				f[y] = wallCount[index] != 0 ? 0.0f : infinity;
+			}
+			DistanceTransform( f.data(), windowHeight, d.data(), vertices.data(), boundaries.data());
+			for (int y = 0; y < windowHeight; ++y)
+			{
+				squared[static_cast< std::size_t >(y * windowWidth + x)] = d[y];
+			}
+		}
+
+		// The rows of the target, of which only the target cells are stored
+		for (int y = aTarget.minY - aWindow.minY; y <= aTarget.maxY - aWindow.minY; ++y)
+		{
+			DistanceTransform( &squared[static_cast< std::size_t >(y * windowWidth)], windowWidth, d.data(), vertices.data(), boundaries.data());
+			for (int x = aTarget.minX - aWindow.minX; x <= aTarget.maxX - aWindow.minX; ++x)
+			{
+				std::size_t index = static_cast< std::size_t >((aWindow.minY + y) * width + aWindow.minX + x);
+				distance[index] = std::min( std::sqrt( d[x]), static_cast< float >(MaximumDistance));
+			}
+		}
+	}
+} // namespace PathAlgorithm
@@ -0,0 +1,185 @@
+#ifndef DISTANCEFIELD_HPP_
+#define DISTANCEFIELD_HPP_
+
+#include "Config.hpp"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "Point.hpp"
+
+namespace PathAlgorithm
+{
+	class DistanceField;
+	typedef std::shared_ptr< const DistanceField > DistanceFieldPtr;
+
+	/**
+	 * The Euclidean distance of every cell of the world to the nearest wall cell, computed with the
+	 * linear time distance transform of Felzenszwalb and Huttenlocher. Whether a round robot of any
+	 * radius fits on a cell is a single compare against the stored distance, so the robots of all
+	 * sizes share the field.
+	 *
+	 * The walls are rasterised as one cell wide lines and every cell counts the walls that cover it.
+	 * When walls are added, deleted or moved only the window around the changed walls is transformed
+	 * again: a wall only changes the distances that are within MaximumDistance of it.
+	 *
+	 * Distances are capped at MaximumDistance. The field extends MaximumDistance beyond the walls so
+	 * that cells outside of it are at least that far from every wall.
+	 */
+	class DistanceField
+	{
+		public:
+			typedef std::pair< Point, Point > Segment;
+			/**
+			 * A rectangle of cells, both corners inclusive, empty if maxX < minX
+			 */
+			struct Region
+			{
+					int minX;
+					int minY;
+					int maxX;
+					int maxY;
+			};
+			// struct Region
+
+			static const int MaximumDistance = 128;
+			/**
+			 *
+			 */
+			DistanceField();
+			/**
+			 * @return the field that is synchronised with the current wall revision of the RobotWorld.
+			 * The field is shared, a returned field is never changed anymore.
+			 */
+			static DistanceFieldPtr getDistanceField();
+			/**
+			 * @return the wall segments of the current wall revision of the RobotWorld
+			 */
+			static std::vector< Segment > getWallSegments();
+			/**
+			 * Brings the field in line with aSegments, only the windows of the segments that differ
+			 * from the segments of the previous synchronisation are transformed again
+			 */
+			void synchronise(	const std::vector< Segment >& aSegments,
+								unsigned long aWallRevision);
+			/**
+			 * @return the distance from the centre of the cell to the centre of the nearest wall cell,
+			 * at most MaximumDistance
+			 */
+			float getDistance(	int anX,
+								int anY) const
+			{
+				return contains( anX, anY) ? distance[static_cast< std::size_t >(anY * width + anX)] : static_cast< float >(MaximumDistance);
+			}
+			/**
+			 *
+			 */
+			float getDistance( const Point& aPoint) const
+			{
+				return getDistance( aPoint.x, aPoint.y);
+			}
+			/**
+			 * @return true if a round robot with aRadius centred on the cell touches no wall
+			 */
+			bool isFree(	int anX,
+							int anY,
+							int aRadius) const
+			{
+				return getDistance( anX, anY) >= static_cast< float >(aRadius);
+			}
+			/**
+			 * Sphere traces the ray from aFrom in the direction anAngle (radians, clockwise from the
+			 * x axis as Utils::Shape2DUtils::getAngle): every step is as long as the distance to the
+			 * nearest wall, so the ray never jumps over one.
+			 *
+			 * @return the distance to the first wall cell on the ray, aMaximumRange if there is none
+			 */
+			double castRay(	const Point& aFrom,
+							double anAngle,
+							double aMaximumRange) const;
+			/**
+			 * @return true if the segment from aFrom to aTo intersects a wall. Only a segment near a
+			 * wall cell is tested against the walls themselves.
+			 */
+			bool intersectsWall(	const Point& aFrom,
+									const Point& aTo) const;
+			/**
+			 * @return the cells of which the distance may have changed since aWallRevision: the
+			 * window of the last synchronisation if aWallRevision was the revision before it, the
+			 * whole field otherwise
+			 */
+			Region getChangedRegion( unsigned long aWallRevision) const;
+			/**
+			 *
+			 */
+			bool contains(	int anX,
+							int anY) const
+			{
+				return anX >= 0 && anY >= 0 && anX < width && anY < height;
+			}
+			/**
+			 *
+			 */
+			int getWidth() const
+			{
+				return width;
+			}
+			/**
+			 *
+			 */
+			int getHeight() const
+			{
+				return height;
+			}
+			/**
+			 *
+			 */
+			unsigned long getWallRevision() const
+			{
+				return wallRevision;
+			}
+			/**
+			 * @return the wall segments of getWallRevision(), sorted
+			 */
+			const std::vector< Segment >& getSegments() const
+			{
+				return segments;
+			}
+
+		private:
+			/**
+			 * Adds aDelta to the wall count of the cells on aSegment and extends aDirty with them
+			 */
+			void rasterise(	const Segment& aSegment,
+							int aDelta,
+							Region& aDirty);
+			/**
+			 *
+			 */
+			void resize(	int aWidth,
+							int aHeight);
+			/**
+			 * Transforms the cells of aWindow, with only the walls inside aWindow, and stores the
+			 * distances of the cells in aTarget, which must be inside aWindow
+			 */
+			void transform(	const Region& aWindow,
+							const Region& aTarget);
+
+			int width;
+			int height;
+			unsigned long wallRevision;
+			unsigned long previousWallRevision;
+			Region changedRegion;
+
+			std::vector< unsigned short > wallCount;
+			std::vector< float > distance;
+			std::vector< Segment > segments;
+	}; // class DistanceField
+	/**
+	 * Orders segments by their first and then by their second point
+	 */
+	bool SegmentLess(	const DistanceField::Segment& lhs,
+						const DistanceField::Segment& rhs);
+} // namespace PathAlgorithm
+#endif // DISTANCEFIELD_HPP_
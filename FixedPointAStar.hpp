@@ -0,0 +1,134 @@
+#ifndef FIXEDPOINTASTAR_HPP_
+#define FIXEDPOINTASTAR_HPP_
+
+#include "Config.hpp"
+
+#include <iostream>
+
+#include "AStar.hpp"
+#include "BucketQueue.hpp"
+#include "CostPolicy.hpp"
+#include "OccupancyGrid.hpp"
+
+namespace PathAlgorithm
+{
+	/**
+	 * A* on the same 8-connected grid as AStar with the step costs and the heuristic taken from
+	 * aCostPolicy at compile time. The costs are integers (see OctileCost), so there is no
+	 * sqrt and no floating point in the inner loop and the openSet is a BucketQueue instead of a
+	 * binary heap.
+	 *
+	 * The open vertices live in the BucketQueue only, so the snapshots have the best path but no
+	 * frontier. The actual costs of the route are converted back into cells.
+	 */
+	template< typename aCostPolicy >
+	class FixedPointAStar : public AStar
+	{
+		public:
+			typedef aCostPolicy CostPolicy;
+			typedef typename CostPolicy::CostType CostType;
+
+			using AStar::search;
+			/**
+			 *
+			 */
+			virtual std::size_t getAllocatedBytes() const
+			{
+				return AStar::getAllocatedBytes() + openQueue.getAllocatedBytes();
+			}
+			/**
+			 *
+			 */
+			virtual Path search(Vertex aStart,
+								const Vertex& aGoal,
+								const Size& aRobotSize)
+			{
+				static const int xOffset[] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+				static const int yOffset[] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+
+				getOS().clear();
+
+				OccupancyGridPtr occupancyGrid = OccupancyGrid::getOccupancyGrid( FreeRadius( aRobotSize));
+
+				SearchWorkspace& workspace = getWS();
+				Size bounds = WorldBounds( aStart, aGoal, *occupancyGrid);
+				workspace.resize( bounds.x, bounds.y);
+				if (!workspace.contains( aStart.x, aStart.y) || !workspace.contains( aGoal.x, aGoal.y))
+				{
+					std::cerr << "**** No route from " << aStart << " to " << aGoal << ": outside of the world" << std::endl;
+					return Path();
+				}
+
+				// f grows at most twice the largest step cost per expansion
+				openQueue.reset( 2 * CostPolicy::MaximumStepCost);
+
+				unsigned int startIndex = workspace.indexOf( aStart.x, aStart.y);
+				unsigned int goalIndex = workspace.indexOf( aGoal.x, aGoal.y);
+				workspace.visit( startIndex, 0.0, SearchWorkspace::NoParent);
+				openQueue.push( CostPolicy::heuristicCost( aStart.x, aStart.y, aGoal.x, aGoal.y), startIndex);
+				countGenerated( openQueue.size());
+
+				while (!openQueue.empty())
+				{
+					unsigned int currentIndex = openQueue.pop();
+					if (workspace.isClosed( currentIndex))
+					{
+						// An outdated entry of a vertex that was pushed again with a lower cost
+						continue;
+					}
+					if (currentIndex == goalIndex)
+					{
+						Path path = workspace.constructPath( goalIndex);
+						for (Vertex& vertex : path)
+						{
+							vertex.actualCost = vertex.heuristicCost = CostPolicy::toCells( static_cast< CostType >(vertex.actualCost));
+						}
+						return path;
+					}
+
+					Vertex current( workspace.xOf( currentIndex), workspace.yOf( currentIndex));
+					CostType currentCost = static_cast< CostType >(workspace.getActualCost( currentIndex));
+					addToClosedSet( current);
+					publishProgress( currentIndex);
+
+					for (int i = 0; i < 8; ++i)
+					{
+						int x = current.x + xOffset[i];
+						int y = current.y + yOffset[i];
+						if (!workspace.contains( x, y) || !occupancyGrid->isFree( x, y))
+						{
+							continue;
+						}
+						unsigned int neighbourIndex = workspace.indexOf( x, y);
+
+						// The heuristic is consistent, a closed vertex has its lowest cost already
+						if (workspace.isClosed( neighbourIndex))
+						{
+							continue;
+						}
+						CostType cost = currentCost + CostPolicy::stepCost( xOffset[i], yOffset[i]);
+						if (workspace.isVisited( neighbourIndex) && static_cast< CostType >(workspace.getActualCost( neighbourIndex)) <= cost)
+						{
+							continue;
+						}
+						workspace.visit( neighbourIndex, static_cast< double >(cost), currentIndex);
+						openQueue.push( cost + CostPolicy::heuristicCost( x, y, aGoal.x, aGoal.y), neighbourIndex);
+						countGenerated( openQueue.size());
+					}
+					OccupancyGrid::countWallChecks( 8);
+				}
+
+				std::cerr << "**** No route from " << aStart << " to " << aGoal << std::endl;
+				return Path();
+			}
+
+		private:
+			BucketQueue openQueue;
+	}; // class FixedPointAStar
+
+	/**
+	 * The fixed-point A* with the default octile costs
+	 */
+	typedef FixedPointAStar< OctileCost<> > OctileAStar;
+} // namespace PathAlgorithm
+#endif // FIXEDPOINTASTAR_HPP_
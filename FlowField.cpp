@@ -0,0 +1,300 @@
+#include "FlowField.hpp"
+#include <functional>
+#include <future>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <tuple>
+
+namespace PathAlgorithm
+{
+	namespace
+	{
+		const int xOffset[] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+		const int yOffset[] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+
+		/**
+		 * A field in the cache, the future is shared by the robots that asked for the field while
+		 * it was computed
+		 */
+		struct Entry
+		{
+				std::shared_future< FlowFieldPtr > flowField;
+				unsigned long wallRevision;
+				unsigned long lastUse;
+		};
+		// struct Entry
+		/**
+		 * (goal x, goal y, radius)
+		 */
+		typedef std::tuple< int, int, int > Key;
+
+		std::mutex registryMutex;
+		std::map< Key, Entry > registry;
+		unsigned long useCount = 0;
+
+		/**
+		 *
+		 */
+		double StepCost( unsigned char aDirection)
+		{
+			return xOffset[aDirection] != 0 && yOffset[aDirection] != 0 ? DiagonalStepCost : 1.0;
+		}
+	} // namespace
+
+	/* static */ const unsigned char FlowField::NoDirection;
+	/* static */ const std::size_t FlowField::Capacity;
+	/**
+	 *
+	 */
+	FlowField::FlowField(	const Point& aGoal,
+							const OccupancyGridPtr& anOccupancyGrid) :
+								goal( aGoal),
+								occupancyGrid( anOccupancyGrid),
+								width( 0),
+								height( 0),
+								expandedCount( 0)
+	{
+		Size bounds = WorldBounds( Vertex( aGoal), Vertex( aGoal), *occupancyGrid);
+		width = bounds.x;
+		height = bounds.y;
+		compute();
+	}
+	/**
+	 *
+	 */
+	/* static */ FlowFieldPtr FlowField::getFlowField(	const Point& aGoal,
+														int aRadius)
+	{
+		OccupancyGridPtr occupancyGrid = OccupancyGrid::getOccupancyGrid( aRadius);
+		unsigned long wallRevision = occupancyGrid->getWallRevision();
+
+		std::promise< FlowFieldPtr > promise;
+		std::shared_future< FlowFieldPtr > flowField;
+		bool compute = false;
+		{
+			std::lock_guard< std::mutex > lock( registryMutex);
+
+			// The fields of the other wall revisions are useless
+			for (std::map< Key, Entry >::iterator i = registry.begin(); i != registry.end();)
+			{
+				if (i->second.wallRevision != wallRevision)
+				{
+					i = registry.erase( i);
+				} else
+				{
+					++i;
+				}
+			}
+
+			Key key( aGoal.x, aGoal.y, aRadius);
+			std::map< Key, Entry >::iterator i = registry.find( key);
+			if (i == registry.end())
+			{
+				if (registry.size() >= Capacity)
+				{
+					std::map< Key, Entry >::iterator leastRecentlyUsed = registry.begin();
+					for (std::map< Key, Entry >::iterator j = registry.begin(); j != registry.end(); ++j)
+					{
+						if (j->second.lastUse < leastRecentlyUsed->second.lastUse)
+						{
+							leastRecentlyUsed = j;
+						}
+					}
+					registry.erase( leastRecentlyUsed);
+				}
+				i = registry.insert( std::make_pair( key, Entry { promise.get_future().share(), wallRevision, 0 })).first;
+				compute = true;
+			}
+			i->second.lastUse = ++useCount;
+			flowField = i->second.flowField;
+		}
+
+		// Computed outside of the lock, the fields of other goals are not held up
+		if (compute)
+		{
+			try
+			{
+				promise.set_value( std::make_shared< FlowField >( aGoal, occupancyGrid));
+			}
+			catch (...)
+			{
+				promise.set_exception( std::current_exception());
+			}
+		}
+		return flowField.get();
+	}
+	/**
+	 *
+	 */
+	/* static */ void FlowField::clear()
+	{
+		std::lock_guard< std::mutex > lock( registryMutex);
+		registry.clear();
+	}
+	/**
+	 *
+	 */
+	Path FlowField::getPath( const Point& aStart) const
+	{
+		Path path;
+		if (!contains( aStart.x, aStart.y))
+		{
+			return path;
+		}
+
+		Vertex current( aStart);
+		unsigned char next = getDirection( current.x, current.y);
+		if (next == NoDirection && !(aStart == goal))
+		{
+			// Occupied, or enclosed by occupied cells
+			double lowestCost = std::numeric_limits< double >::infinity();
+			for (unsigned char d = 0; d < NoDirection; ++d)
+			{
+				int x = current.x + xOffset[d];
+				int y = current.y + yOffset[d];
+				if (occupancyGrid->isFree( x, y) && getCost( x, y) + StepCost( d) < lowestCost)
+				{
+					lowestCost = getCost( x, y) + StepCost( d);
+					next = d;
+				}
+			}
+			OccupancyGrid::countWallChecks( NoDirection);
+			if (next == NoDirection)
+			{
+				return path;
+			}
+		}
+
+		path.push_back( current);
+		while (next != NoDirection)
+		{
+			current.x += xOffset[next];
+			current.y += yOffset[next];
+			current.actualCost = current.heuristicCost = current.actualCost + StepCost( next);
+			path.push_back( current);
+			next = getDirection( current.x, current.y);
+		}
+		return path;
+	}
+	/**
+	 *
+	 */
+	double FlowField::getCost(	int anX,
+								int anY) const
+	{
+		return contains( anX, anY) ? cost[static_cast< std::size_t >(anY * width + anX)] : std::numeric_limits< double >::infinity();
+	}
+	/**
+	 *
+	 */
+	/* static */ Point FlowField::getStep( unsigned char aDirection)
+	{
+		return Point( xOffset[aDirection], yOffset[aDirection]);
+	}
+	/**
+	 *
+	 */
+	void FlowField::compute()
+	{
+		std::size_t size = static_cast< std::size_t >(width) * static_cast< std::size_t >(height);
+
+		// A goal that no robot can stand on can not be reached, as with AStar
+		if (!occupancyGrid->isFree( goal.x, goal.y))
+		{
+			direction.assign( size, NoDirection);
+			cost.assign( size, std::numeric_limits< float >::infinity());
+			return;
+		}
+
+		// The costs are summed in double, the field only stores them as float
+		std::vector< double > costs;
+		expandedCount = ComputeCosts( *occupancyGrid, goal, width, height, costs, &direction);
+		cost.assign( costs.begin(), costs.end());
+	}
+	/**
+	 *
+	 */
+	unsigned long ComputeCosts(	const OccupancyGrid& anOccupancyGrid,
+								const Point& aSource,
+								int aWidth,
+								int aHeight,
+								std::vector< double >& aCosts,
+								std::vector< unsigned char >* aDirections)
+	{
+		std::size_t size = static_cast< std::size_t >(aWidth) * static_cast< std::size_t >(aHeight);
+		aCosts.assign( size, std::numeric_limits< double >::infinity());
+		if (aDirections)
+		{
+			aDirections->assign( size, FlowField::NoDirection);
+		}
+
+		typedef std::pair< double, unsigned int > QueueEntry;
+		std::priority_queue< QueueEntry, std::vector< QueueEntry >, std::greater< QueueEntry > > openSet;
+		std::vector< bool > closed( size, false);
+		unsigned long expandedCount = 0;
+
+		unsigned int sourceIndex = static_cast< unsigned int >(aSource.y * aWidth + aSource.x);
+		aCosts[sourceIndex] = 0.0;
+		openSet.push( QueueEntry( 0.0, sourceIndex));
+		while (!openSet.empty())
+		{
+			QueueEntry current = openSet.top();
+			openSet.pop();
+			if (closed[current.second])
+			{
+				continue;
+			}
+			closed[current.second] = true;
+			++expandedCount;
+
+			int x = static_cast< int >(current.second % static_cast< unsigned int >(aWidth));
+			int y = static_cast< int >(current.second / static_cast< unsigned int >(aWidth));
+			for (unsigned char d = 0; d < FlowField::NoDirection; ++d)
+			{
+				int neighbourX = x + xOffset[d];
+				int neighbourY = y + yOffset[d];
+				if (neighbourX < 0 || neighbourY < 0 || neighbourX >= aWidth || neighbourY >= aHeight || !anOccupancyGrid.isFree( neighbourX, neighbourY))
+				{
+					continue;
+				}
+				unsigned int neighbourIndex = static_cast< unsigned int >(neighbourY * aWidth + neighbourX);
+				double calculatedCost = current.first + StepCost( d);
+				if (!closed[neighbourIndex] && calculatedCost < aCosts[neighbourIndex])
+				{
+					aCosts[neighbourIndex] = calculatedCost;
+					if (aDirections)
+					{
+						// The neighbour steps back to the cell it was reached from
+						(*aDirections)[neighbourIndex] = static_cast< unsigned char >((d + 4) % FlowField::NoDirection);
+					}
+					openSet.push( QueueEntry( calculatedCost, neighbourIndex));
+				}
+			}
+		}
+		OccupancyGrid::countWallChecks( expandedCount * FlowField::NoDirection);
+		return expandedCount;
+	}
+	/**
+	 *
+	 */
+	Path FlowFieldSearch::search(	Vertex aStart,
+									const Vertex& aGoal,
+									const Size& aRobotSize)
+	{
+		FlowFieldPtr flowField = FlowField::getFlowField( aGoal.asPoint(), FreeRadius( aRobotSize));
+		if (!flowField->contains( aStart.x, aStart.y))
+		{
+			return AStar::search( aStart, aGoal, aRobotSize);
+		}
+
+		Path path = flowField->getPath( aStart.asPoint());
+		if (path.empty())
+		{
+			std::cerr << "**** No route from " << aStart << " to " << aGoal << std::endl;
+		}
+		return path;
+	}
+} // namespace PathAlgorithm
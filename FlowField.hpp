@@ -0,0 +1,176 @@
+#ifndef FLOWFIELD_HPP_
+#define FLOWFIELD_HPP_
+
+#include "Config.hpp"
+
+#include <memory>
+#include <vector>
+
+#include "AStar.hpp"
+#include "OccupancyGrid.hpp"
+
+namespace PathAlgorithm
+{
+	class FlowField;
+	typedef std::shared_ptr< const FlowField > FlowFieldPtr;
+
+	/**
+	 * The routes of every cell to one goal: a Dijkstra search from the goal over the occupancy
+	 * grid of a radius stores per cell the cost to the goal and the direction of the next step.
+	 * Robots of the same radius heading for the same goal share the field, after which following
+	 * it costs one lookup per step.
+	 *
+	 * The fields are cached per goal and radius for the wall revision of their occupancy grid and
+	 * are never changed once computed. When several robots ask for a missing field at the same
+	 * time one computes it and the others wait for it.
+	 */
+	class FlowField
+	{
+		public:
+			/**
+			 * The direction of the goal itself and of the cells that can not reach it
+			 */
+			static const unsigned char NoDirection = 8;
+			/**
+			 * The number of fields kept in the cache
+			 */
+			static const std::size_t Capacity = 16;
+			/**
+			 * Computes the field of aGoal on anOccupancyGrid
+			 */
+			FlowField(	const Point& aGoal,
+						const OccupancyGridPtr& anOccupancyGrid);
+			/**
+			 * @return the field of aGoal for aRadius in the current wall revision, computed if it is
+			 * not in the cache
+			 */
+			static FlowFieldPtr getFlowField(	const Point& aGoal,
+												int aRadius);
+			/**
+			 * Empties the cache
+			 */
+			static void clear();
+			/**
+			 * @return the route from aStart to the goal, empty if there is none. A start on an
+			 * occupied cell is left through its cheapest free neighbour, as AStar does.
+			 */
+			Path getPath( const Point& aStart) const;
+			/**
+			 * @return the cost of the route from the cell to the goal, infinity if there is none
+			 */
+			double getCost(	int anX,
+							int anY) const;
+			/**
+			 * @return the direction of the next step of the cell, an index in the offsets of
+			 * getStep, NoDirection for the goal and for cells that can not reach it
+			 */
+			unsigned char getDirection(	int anX,
+										int anY) const
+			{
+				return contains( anX, anY) ? direction[static_cast< std::size_t >(anY * width + anX)] : NoDirection;
+			}
+			/**
+			 * @return the step of aDirection, aDirection must not be NoDirection
+			 */
+			static Point getStep( unsigned char aDirection);
+			/**
+			 *
+			 */
+			bool contains(	int anX,
+							int anY) const
+			{
+				return anX >= 0 && anY >= 0 && anX < width && anY < height;
+			}
+			/**
+			 *
+			 */
+			const Point& getGoal() const
+			{
+				return goal;
+			}
+			/**
+			 *
+			 */
+			int getRadius() const
+			{
+				return occupancyGrid->getRadius();
+			}
+			/**
+			 *
+			 */
+			unsigned long getWallRevision() const
+			{
+				return occupancyGrid->getWallRevision();
+			}
+			/**
+			 * @return the number of cells the Dijkstra search expanded
+			 */
+			unsigned long getExpandedCount() const
+			{
+				return expandedCount;
+			}
+			/**
+			 *
+			 */
+			std::size_t getAllocatedBytes() const
+			{
+				return direction.capacity() * sizeof( unsigned char) + cost.capacity() * sizeof( float);
+			}
+
+		private:
+			/**
+			 *
+			 */
+			void compute();
+
+			Point goal;
+			OccupancyGridPtr occupancyGrid;
+			int width;
+			int height;
+			unsigned long expandedCount;
+
+			std::vector< unsigned char > direction;
+			std::vector< float > cost;
+	}; // class FlowField
+
+	/**
+	 * A Dijkstra search from aSource over the free cells of anOccupancyGrid within the first
+	 * aWidth by aHeight cells, with straight and diagonal steps. The steps cost the same both
+	 * ways, so the cost from aSource to a cell is also the cost from the cell to aSource.
+	 *
+	 * @param aCosts gets per cell (y * aWidth + x) the cost of its route, infinity if there is none
+	 * @param aDirections if given gets per cell the direction of its first step towards aSource,
+	 * as FlowField::getDirection
+	 * @return the number of cells expanded
+	 */
+	unsigned long ComputeCosts(	const OccupancyGrid& anOccupancyGrid,
+								const Point& aSource,
+								int aWidth,
+								int aHeight,
+								std::vector< double >& aCosts,
+								std::vector< unsigned char >* aDirections = nullptr);
+
+	/**
+	 * Follows the FlowField of the goal instead of searching. Starts outside of the field, which
+	 * covers the occupancy grid and the goal, are searched with AStar.
+	 */
+	class FlowFieldSearch : public AStar
+	{
+		public:
+			using AStar::search;
+			/**
+			 *
+			 */
+			virtual Path search(Vertex aStart,
+								const Vertex& aGoal,
+								const Size& aRobotSize);
+			/**
+			 * The flow fields are a cache of their own
+			 */
+			virtual bool isCacheable() const
+			{
+				return false;
+			}
+	}; // class FlowFieldSearch
+} // namespace PathAlgorithm
+#endif // FLOWFIELD_HPP_
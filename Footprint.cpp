@@ -0,0 +1,164 @@
+#include "Footprint.hpp"
+#include "OccupancyGrid.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace PathAlgorithm
+{
+	namespace
+	{
+		/**
+		 * A rectangle at a pose along the sweep
+		 */
+		struct Pose
+		{
+				double cos;
+				double sin;
+				double x;
+				double y;
+		};
+		// struct Pose
+	} // namespace
+
+	/**
+	 *
+	 */
+	Footprint::Footprint(	const Size& aRobotSize,
+							double anAngle) :
+								innerRadius( 0.0),
+								outerRadius( 0.0)
+	{
+		rasterise( aRobotSize, anAngle, anAngle, 0.0, 0.0);
+	}
+	/**
+	 *
+	 */
+	Footprint::Footprint(	const Size& aRobotSize,
+							double aFromAngle,
+							double aToAngle,
+							double aDx,
+							double aDy) :
+								innerRadius( 0.0),
+								outerRadius( 0.0)
+	{
+		rasterise( aRobotSize, aFromAngle, aToAngle, aDx, aDy);
+	}
+	/**
+	 *
+	 */
+	bool Footprint::isFree(	const DistanceField& aDistanceField,
+							int anX,
+							int anY) const
+	{
+		float clearance = aDistanceField.getDistance( anX, anY);
+		if (clearance > outerRadius)
+		{
+			OccupancyGrid::countWallChecks( 1);
+			return true;
+		}
+		if (clearance < innerRadius)
+		{
+			OccupancyGrid::countWallChecks( 1);
+			return false;
+		}
+
+		// No wall is nearer to a cell than its distance, so the cells in between are skipped
+		unsigned long wallChecks = 1;
+		bool free = true;
+		for (std::vector< Span >::const_iterator span = spans.begin(); free && span != spans.end(); ++span)
+		{
+			int y = anY + span->dy;
+			for (int x = anX + span->from; x <= anX + span->to;)
+			{
+				float distance = aDistanceField.getDistance( x, y);
+				++wallChecks;
+				if (distance == 0.0f)
+				{
+					free = false;
+					break;
+				}
+				x += static_cast< int >(std::ceil( distance));
+			}
+		}
+		OccupancyGrid::countWallChecks( wallChecks);
+		return free;
+	}
+	/**
+	 *
+	 */
+	std::size_t Footprint::getCellCount() const
+	{
+		std::size_t cellCount = 0;
+		for (const Span& span : spans)
+		{
+			cellCount += static_cast< std::size_t >(span.to - span.from + 1);
+		}
+		return cellCount;
+	}
+	/**
+	 *
+	 */
+	void Footprint::rasterise(	const Size& aRobotSize,
+								double aFromAngle,
+								double aToAngle,
+								double aDx,
+								double aDy)
+	{
+		double halfLength = aRobotSize.y / 2.0;
+		double halfWidth = aRobotSize.x / 2.0;
+		double circumradius = std::sqrt( halfLength * halfLength + halfWidth * halfWidth);
+		double translation = std::sqrt( aDx * aDx + aDy * aDy);
+
+		// The poses are close enough that no point of the rectangle moves more than half a cell
+		// from one to the next
+		std::vector< Pose > poses;
+		int turnSteps = std::max( 1, static_cast< int >(std::ceil( std::fabs( aToAngle - aFromAngle) * circumradius * 2.0)));
+		for (int i = 0; i <= turnSteps; ++i)
+		{
+			double angle = aFromAngle + (aToAngle - aFromAngle) * i / turnSteps;
+			poses.push_back( Pose { std::cos( angle), std::sin( angle), 0.0, 0.0 });
+		}
+		int driveSteps = static_cast< int >(std::ceil( translation * 2.0));
+		for (int i = 1; i <= driveSteps; ++i)
+		{
+			poses.push_back( Pose { std::cos( aToAngle), std::sin( aToAngle), aDx * i / driveSteps, aDy * i / driveSteps });
+		}
+
+		// One cell beyond the furthest corner, so the nearest uncovered cell is found as well
+		int extent = static_cast< int >(std::ceil( circumradius + translation)) + 1;
+		innerRadius = std::numeric_limits< double >::infinity();
+		outerRadius = 0.0;
+		spans.clear();
+		for (int y = -extent; y <= extent; ++y)
+		{
+			bool inSpan = false;
+			for (int x = -extent; x <= extent; ++x)
+			{
+				bool covered = false;
+				for (std::vector< Pose >::const_iterator pose = poses.begin(); !covered && pose != poses.end(); ++pose)
+				{
+					double along = (x - pose->x) * pose->cos + (y - pose->y) * pose->sin;
+					double across = (y - pose->y) * pose->cos - (x - pose->x) * pose->sin;
+					covered = std::fabs( along) <= halfLength && std::fabs( across) <= halfWidth;
+				}
+
+				double distance = std::sqrt( static_cast< double >(x * x + y * y));
+				if (covered)
+				{
+					outerRadius = std::max( outerRadius, distance);
+					if (!inSpan)
+					{
+						spans.push_back( Span { y, x, x });
+						inSpan = true;
+					}
+					spans.back().to = x;
+				} else
+				{
+					innerRadius = std::min( innerRadius, distance);
+					inSpan = false;
+				}
+			}
+		}
+	}
+} // namespace PathAlgorithm
@@ -0,0 +1,94 @@
+#ifndef FOOTPRINT_HPP_
+#define FOOTPRINT_HPP_
+
+#include "Config.hpp"
+
+#include <vector>
+
+#include "DistanceField.hpp"
+#include "Size.hpp"
+
+namespace PathAlgorithm
+{
+	/**
+	 * The cells covered by the rectangle of a robot, or by the area it sweeps while it turns on
+	 * the spot or drives a short step, relative to the cell of the centre of the robot. A cell
+	 * is covered if its centre lies in the rectangle.
+	 *
+	 * The cells are stored as spans per row. A pose is tested against the walls of the
+	 * DistanceField: if the nearest wall is further away than the furthest covered cell the pose
+	 * is free, if it is nearer than the nearest uncovered cell it is not, and in between the
+	 * spans are traced with steps as long as the distance to the nearest wall.
+	 */
+	class Footprint
+	{
+		public:
+			/**
+			 * The rectangle of aRobotSize with its length, aRobotSize.y, along anAngle (radians,
+			 * clockwise from the x axis as the front of a Robot) and its width, aRobotSize.x,
+			 * across
+			 */
+			Footprint(	const Size& aRobotSize,
+						double anAngle);
+			/**
+			 * The area swept by the rectangle of aRobotSize while it turns from aFromAngle to
+			 * aToAngle and then drives straight to (aDx, aDy)
+			 */
+			Footprint(	const Size& aRobotSize,
+						double aFromAngle,
+						double aToAngle,
+						double aDx,
+						double aDy);
+			/**
+			 * @return true if the footprint touches no wall of aDistanceField with its centre on
+			 * (anX, anY)
+			 */
+			bool isFree(	const DistanceField& aDistanceField,
+							int anX,
+							int anY) const;
+			/**
+			 * @return the distance of the nearest cell that is not covered, any wall nearer than
+			 * this is covered
+			 */
+			double getInnerRadius() const
+			{
+				return innerRadius;
+			}
+			/**
+			 * @return the distance of the furthest covered cell
+			 */
+			double getOuterRadius() const
+			{
+				return outerRadius;
+			}
+			/**
+			 * @return the number of covered cells
+			 */
+			std::size_t getCellCount() const;
+
+		private:
+			/**
+			 * The covered cells from (from, dy) up to and including (to, dy)
+			 */
+			struct Span
+			{
+					int dy;
+					int from;
+					int to;
+			};
+			// struct Span
+			/**
+			 *
+			 */
+			void rasterise(	const Size& aRobotSize,
+							double aFromAngle,
+							double aToAngle,
+							double aDx,
+							double aDy);
+
+			std::vector< Span > spans;
+			double innerRadius;
+			double outerRadius;
+	}; // class Footprint
+} // namespace PathAlgorithm
+#endif // FOOTPRINT_HPP_
@@ -0,0 +1,207 @@
+#include "HierarchicalAStar.hpp"
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+namespace PathAlgorithm
+{
+	/**
+	 *
+	 */
+	HierarchicalAStar::HierarchicalAStar( int aClusterSize /* = 32 */) :
+								clusterSize( aClusterSize),
+								radius( -1),
+								clusterGraph( aClusterSize)
+	{
+	}
+	/**
+	 *
+	 */
+	Path HierarchicalAStar::search(	Vertex aStart,
+									const Vertex& aGoal,
+									const Size& aRobotSize)
+	{
+		abstractPath.clear();
+
+		int freeRadius = FreeRadius( aRobotSize);
+		OccupancyGridPtr occupancyGrid = OccupancyGrid::getOccupancyGrid( freeRadius);
+
+		Size bounds = WorldBounds( aStart, aGoal, *occupancyGrid);
+		if (aStart.x < 0 || aStart.y < 0 || aGoal.x < 0 || aGoal.y < 0)
+		{
+			std::cerr << "**** No route from " << aStart << " to " << aGoal << ": outside of the world" << std::endl;
+			return Path();
+		}
+
+		// A robot that is too close to a wall can only get away cell by cell
+		if (aStart.equalPoint( aGoal) || !occupancyGrid->isFree( aStart.x, aStart.y))
+		{
+			return AStar::search( aStart, aGoal, aRobotSize);
+		}
+		if (!occupancyGrid->isFree( aGoal.x, aGoal.y))
+		{
+			std::cerr << "**** No route from " << aStart << " to " << aGoal << std::endl;
+			return Path();
+		}
+
+		if (freeRadius != radius)
+		{
+			clusterGraph = ClusterGraph( clusterSize);
+			radius = freeRadius;
+		}
+		clusterGraph.synchronise( occupancyGrid, bounds.x, bounds.y);
+
+		getOS().clear();
+		SearchWorkspace& workspace = getWS();
+		workspace.resize( bounds.x, bounds.y);
+
+		unsigned int startCell = workspace.indexOf( aStart.x, aStart.y);
+		unsigned int goalCell = workspace.indexOf( aGoal.x, aGoal.y);
+		unsigned int startClusterIndex = clusterGraph.getClusterIndex( aStart.x, aStart.y);
+		unsigned int goalClusterIndex = clusterGraph.getClusterIndex( aGoal.x, aGoal.y);
+		const ClusterGraph::Cluster& startCluster = clusterGraph.getCluster( startClusterIndex);
+		const ClusterGraph::Cluster& goalCluster = clusterGraph.getCluster( goalClusterIndex);
+
+		// Connect the start and the goal to the entrance nodes of their clusters
+		std::vector< double > startDistances;
+		std::vector< double > goalDistances;
+		std::vector< unsigned int > parents;
+		clusterGraph.searchCluster( startCluster, startCell, startDistances, parents);
+		clusterGraph.searchCluster( goalCluster, goalCell, goalDistances, parents);
+		int startClusterWidth = startCluster.maxX - startCluster.minX + 1;
+		int goalClusterWidth = goalCluster.maxX - goalCluster.minX + 1;
+
+		aStart.actualCost = 0.0;
+		aStart.heuristicCost = HeuristicCost( aStart, aGoal);
+		workspace.visit( startCell, 0.0, SearchWorkspace::NoParent);
+		addToOpenSet( aStart);
+
+		std::vector< ClusterGraph::Edge > edges;
+		while (!getOS().empty())
+		{
+			Vertex current = getOS().top();
+			unsigned int currentCell = workspace.indexOf( current.x, current.y);
+
+			if (currentCell == goalCell)
+			{
+				abstractPath = workspace.constructPath( goalCell);
+
+				Path path( 1, abstractPath.front());
+				for (std::size_t i = 1; i < abstractPath.size(); ++i)
+				{
+					Path segment = refine( abstractPath[i - 1], abstractPath[i]);
+					path.insert( path.end(), segment.begin(), segment.end());
+				}
+				return path;
+			}
+
+			addToClosedSet( current);
+			removeFirstFromOpenSet();
+			publishProgress( currentCell);
+
+			edges.clear();
+			if (currentCell == startCell)
+			{
+				for (unsigned int node : startCluster.nodes)
+				{
+					double distance = startDistances[static_cast< std::size_t >((workspace.yOf( node) - startCluster.minY) * startClusterWidth + workspace.xOf( node) - startCluster.minX)];
+					if (distance != std::numeric_limits< double >::infinity())
+					{
+						edges.push_back( ClusterGraph::Edge( node, distance));
+					}
+				}
+				if (startClusterIndex == goalClusterIndex)
+				{
+					double distance = startDistances[static_cast< std::size_t >((aGoal.y - startCluster.minY) * startClusterWidth + aGoal.x - startCluster.minX)];
+					if (distance != std::numeric_limits< double >::infinity())
+					{
+						edges.push_back( ClusterGraph::Edge( goalCell, distance));
+					}
+				}
+			}
+			if (clusterGraph.isNode( currentCell))
+			{
+				clusterGraph.getEdges( currentCell, edges);
+				if (clusterGraph.getClusterIndex( current.x, current.y) == goalClusterIndex)
+				{
+					double distance = goalDistances[static_cast< std::size_t >((current.y - goalCluster.minY) * goalClusterWidth + current.x - goalCluster.minX)];
+					if (distance != std::numeric_limits< double >::infinity())
+					{
+						edges.push_back( ClusterGraph::Edge( goalCell, distance));
+					}
+				}
+			}
+
+			for (const ClusterGraph::Edge& edge : edges)
+			{
+				double calculatedActualCost = current.actualCost + edge.second;
+				if (workspace.isVisited( edge.first) && workspace.getActualCost( edge.first) <= calculatedActualCost)
+				{
+					continue;
+				}
+				bool inOpenSet = workspace.isVisited( edge.first) && !workspace.isClosed( edge.first);
+
+				Vertex neighbour( workspace.xOf( edge.first), workspace.yOf( edge.first));
+				if (workspace.isClosed( edge.first))
+				{
+					removeFromClosedSet( neighbour);
+				}
+				neighbour.actualCost = calculatedActualCost;
+				neighbour.heuristicCost = calculatedActualCost + HeuristicCost( neighbour, aGoal);
+				workspace.visit( edge.first, calculatedActualCost, currentCell);
+
+				if (inOpenSet)
+				{
+					updateInOpenSet( neighbour);
+				} else
+				{
+					addToOpenSet( neighbour);
+				}
+			}
+		}
+
+		std::cerr << "**** No route from " << aStart << " to " << aGoal << std::endl;
+		return Path();
+	}
+	/**
+	 *
+	 */
+	Path HierarchicalAStar::refine(	const Vertex& aFrom,
+									const Vertex& aTo) const
+	{
+		Path segment;
+
+		unsigned int fromClusterIndex = clusterGraph.getClusterIndex( aFrom.x, aFrom.y);
+		if (fromClusterIndex != clusterGraph.getClusterIndex( aTo.x, aTo.y))
+		{
+			// A transition between two clusters is a single step
+			Vertex to( aTo.x, aTo.y);
+			to.actualCost = to.heuristicCost = aTo.actualCost;
+			segment.push_back( to);
+			return segment;
+		}
+
+		const ClusterGraph::Cluster& cluster = clusterGraph.getCluster( fromClusterIndex);
+		int clusterWidth = cluster.maxX - cluster.minX + 1;
+		int worldWidth = getWS().getWidth();
+
+		std::vector< double > distances;
+		std::vector< unsigned int > parents;
+		clusterGraph.searchCluster(	cluster,
+									static_cast< unsigned int >(aFrom.y * worldWidth + aFrom.x),
+									distances,
+									parents,
+									static_cast< unsigned int >(aTo.y * worldWidth + aTo.x));
+
+		unsigned int local = static_cast< unsigned int >((aTo.y - cluster.minY) * clusterWidth + aTo.x - cluster.minX);
+		unsigned int fromLocal = static_cast< unsigned int >((aFrom.y - cluster.minY) * clusterWidth + aFrom.x - cluster.minX);
+		for (; local != fromLocal; local = parents[local])
+		{
+			Vertex vertex( cluster.minX + static_cast< int >(local % static_cast< unsigned int >(clusterWidth)), cluster.minY + static_cast< int >(local / static_cast< unsigned int >(clusterWidth)));
+			vertex.actualCost = vertex.heuristicCost = aFrom.actualCost + distances[local];
+			segment.push_back( vertex);
+		}
+		std::reverse( segment.begin(), segment.end());
+		return segment;
+	}
+} // namespace PathAlgorithm
@@ -0,0 +1,69 @@
+#ifndef HIERARCHICALASTAR_HPP_
+#define HIERARCHICALASTAR_HPP_
+
+#include "Config.hpp"
+
+#include <vector>
+
+#include "AStar.hpp"
+#include "ClusterGraph.hpp"
+
+namespace PathAlgorithm
+{
+	/**
+	 * Hierarchical path finding (HPA*) on the same 8-connected grid as AStar.
+	 *
+	 * The search runs on the ClusterGraph: the start and the goal are connected to the entrance
+	 * nodes of their clusters, the abstract route is searched with A* and only then every abstract
+	 * edge is refined into cells by a search inside its cluster. The cost of a search grows with
+	 * the number of clusters the route crosses instead of with the area of the world. The route
+	 * may be slightly longer than the AStar route because it has to go through entrance nodes.
+	 *
+	 * The ClusterGraph is kept between searches and follows the wall revisions incrementally.
+	 */
+	class HierarchicalAStar : public AStar
+	{
+		public:
+			using AStar::search;
+			/**
+			 *
+			 */
+			explicit HierarchicalAStar( int aClusterSize = 32);
+			/**
+			 *
+			 */
+			virtual Path search(Vertex aStart,
+								const Vertex& aGoal,
+								const Size& aRobotSize);
+			/**
+			 * The routes go through the entrance nodes, so they may be longer than those of AStar
+			 * that share the PathCache
+			 */
+			virtual bool isCacheable() const
+			{
+				return false;
+			}
+			/**
+			 * @return the abstract route of the last search: the start, the entrance nodes and the goal
+			 */
+			const Path& getAbstractPath() const
+			{
+				return abstractPath;
+			}
+			/**
+			 * Refines the abstract edge from aFrom to aTo, which must be consecutive vertices of the
+			 * abstract route of the last search, into cells
+			 *
+			 * @return the cells after aFrom up to and including aTo
+			 */
+			Path refine(	const Vertex& aFrom,
+							const Vertex& aTo) const;
+
+		private:
+			int clusterSize;
+			int radius;
+			ClusterGraph clusterGraph;
+			Path abstractPath;
+	}; // class HierarchicalAStar
+} // namespace PathAlgorithm
+#endif // HIERARCHICALASTAR_HPP_
@@ -0,0 +1,239 @@
+#include "JumpPointSearch.hpp"
+#include <iostream>
+
+namespace PathAlgorithm
+{
+	/**
+	 *
+	 */
+	JumpPointSearch::JumpPointSearch() :
+								width( 0),
+								height( 0),
+								wallCheckCount( 0)
+	{
+	}
+	/**
+	 *
+	 */
+	Path JumpPointSearch::search(	Vertex aStart,
+									const Vertex& aGoal,
+									const Size& aRobotSize)
+	{
+		getOS().clear();
+
+		occupancyGrid = OccupancyGrid::getOccupancyGrid( FreeRadius( aRobotSize));
+
+		SearchWorkspace& workspace = getWS();
+		Size bounds = WorldBounds( aStart, aGoal, *occupancyGrid);
+		workspace.resize( bounds.x, bounds.y);
+		width = bounds.x;
+		height = bounds.y;
+		if (!workspace.contains( aStart.x, aStart.y) || !workspace.contains( aGoal.x, aGoal.y))
+		{
+			std::cerr << "**** No route from " << aStart << " to " << aGoal << ": outside of the world" << std::endl;
+			return Path();
+		}
+
+		aStart.actualCost = 0.0;
+		aStart.heuristicCost = aStart.actualCost + HeuristicCost( aStart, aGoal);
+
+		workspace.visit( workspace.indexOf( aStart.x, aStart.y), aStart.actualCost, SearchWorkspace::NoParent);
+		addToOpenSet( aStart);
+
+		while (!getOS().empty())
+		{
+			Vertex current = getOS().top();
+			unsigned int currentIndex = workspace.indexOf( current.x, current.y);
+
+			if (current.equalPoint( aGoal))
+			{
+				return interpolate( workspace.constructPath( currentIndex));
+			}
+
+			addToClosedSet( current);
+			removeFirstFromOpenSet();
+			publishProgress( currentIndex);
+
+			int xDirections[8];
+			int yDirections[8];
+			int numberOfDirections = getDirections( current, workspace.getParent( currentIndex), xDirections, yDirections);
+			for (int i = 0; i < numberOfDirections; ++i)
+			{
+				Vertex jumpPoint( 0, 0);
+				if (!jump( current.x + xDirections[i], current.y + yDirections[i], xDirections[i], yDirections[i], aGoal, jumpPoint))
+				{
+					continue;
+				}
+
+				unsigned int jumpPointIndex = workspace.indexOf( jumpPoint.x, jumpPoint.y);
+				if (workspace.isClosed( jumpPointIndex))
+				{
+					continue;
+				}
+
+				double calculatedActualCost = current.actualCost + ActualCost( current, jumpPoint);
+				if (workspace.isVisited( jumpPointIndex) && workspace.getActualCost( jumpPointIndex) <= calculatedActualCost)
+				{
+					continue;
+				}
+				bool inOpenSet = workspace.isVisited( jumpPointIndex);
+
+				jumpPoint.actualCost = calculatedActualCost;
+				jumpPoint.heuristicCost = calculatedActualCost + HeuristicCost( jumpPoint, aGoal);
+				workspace.visit( jumpPointIndex, calculatedActualCost, currentIndex);
+
+				if (inOpenSet)
+				{
+					updateInOpenSet( jumpPoint);
+				} else
+				{
+					addToOpenSet( jumpPoint);
+				}
+			}
+			OccupancyGrid::countWallChecks( wallCheckCount);
+			wallCheckCount = 0;
+		}
+
+		std::cerr << "**** No route from " << aStart << " to " << aGoal << std::endl;
+		return Path();
+	}
+	/**
+	 *
+	 */
+	int JumpPointSearch::getDirections(	const Vertex& aVertex,
+										unsigned int aParent,
+										int* anXDirections,
+										int* anYDirections) const
+	{
+		int n = 0;
+		if (aParent == SearchWorkspace::NoParent)
+		{
+			static int xOffset[] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+			static int yOffset[] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+			for (; n < 8; ++n)
+			{
+				anXDirections[n] = xOffset[n];
+				anYDirections[n] = yOffset[n];
+			}
+			return n;
+		}
+
+		int x = aVertex.x;
+		int y = aVertex.y;
+		int dx = Sign( x - static_cast< int >(aParent % static_cast< unsigned int >(width)));
+		int dy = Sign( y - static_cast< int >(aParent / static_cast< unsigned int >(width)));
+
+		// The natural neighbours first, then the forced neighbours
+		if (dx != 0 && dy != 0)
+		{
+			anXDirections[n] = 0;	anYDirections[n++] = dy;
+			anXDirections[n] = dx;	anYDirections[n++] = 0;
+			anXDirections[n] = dx;	anYDirections[n++] = dy;
+			if (!isWalkable( x - dx, y))
+			{
+				anXDirections[n] = -dx;	anYDirections[n++] = dy;
+			}
+			if (!isWalkable( x, y - dy))
+			{
+				anXDirections[n] = dx;	anYDirections[n++] = -dy;
+			}
+		} else if (dx != 0)
+		{
+			anXDirections[n] = dx;	anYDirections[n++] = 0;
+			if (!isWalkable( x, y + 1))
+			{
+				anXDirections[n] = dx;	anYDirections[n++] = 1;
+			}
+			if (!isWalkable( x, y - 1))
+			{
+				anXDirections[n] = dx;	anYDirections[n++] = -1;
+			}
+		} else
+		{
+			anXDirections[n] = 0;	anYDirections[n++] = dy;
+			if (!isWalkable( x + 1, y))
+			{
+				anXDirections[n] = 1;	anYDirections[n++] = dy;
+			}
+			if (!isWalkable( x - 1, y))
+			{
+				anXDirections[n] = -1;	anYDirections[n++] = dy;
+			}
+		}
+		return n;
+	}
+	/**
+	 *
+	 */
+	bool JumpPointSearch::jump(	int anX,
+								int anY,
+								int aDX,
+								int aDY,
+								const Vertex& aGoal,
+								Vertex& aJumpPoint) const
+	{
+		for (;; anX += aDX, anY += aDY)
+		{
+			if (!isWalkable( anX, anY))
+			{
+				return false;
+			}
+
+			bool isJumpPoint = anX == aGoal.x && anY == aGoal.y;
+			if (!isJumpPoint)
+			{
+				if (aDX != 0 && aDY != 0)
+				{
+					Vertex straightJumpPoint( 0, 0);
+					isJumpPoint = (isWalkable( anX - aDX, anY + aDY) && !isWalkable( anX - aDX, anY)) ||
+								  (isWalkable( anX + aDX, anY - aDY) && !isWalkable( anX, anY - aDY)) ||
+								  jump( anX + aDX, anY, aDX, 0, aGoal, straightJumpPoint) ||
+								  jump( anX, anY + aDY, 0, aDY, aGoal, straightJumpPoint);
+				} else if (aDX != 0)
+				{
+					isJumpPoint = (isWalkable( anX + aDX, anY + 1) && !isWalkable( anX, anY + 1)) ||
+								  (isWalkable( anX + aDX, anY - 1) && !isWalkable( anX, anY - 1));
+				} else
+				{
+					isJumpPoint = (isWalkable( anX + 1, anY + aDY) && !isWalkable( anX + 1, anY)) ||
+								  (isWalkable( anX - 1, anY + aDY) && !isWalkable( anX - 1, anY));
+				}
+			}
+
+			if (isJumpPoint)
+			{
+				aJumpPoint = Vertex( anX, anY);
+				return true;
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	/* static */ Path JumpPointSearch::interpolate( const Path& aPath)
+	{
+		Path path;
+		if (aPath.empty())
+		{
+			return path;
+		}
+
+		path.push_back( aPath.front());
+		for (std::size_t i = 1; i < aPath.size(); ++i)
+		{
+			int dx = Sign( aPath[i].x - aPath[i - 1].x);
+			int dy = Sign( aPath[i].y - aPath[i - 1].y);
+
+			Vertex vertex = path.back();
+			while (!vertex.equalPoint( aPath[i]))
+			{
+				Vertex next( vertex.x + dx, vertex.y + dy);
+				next.actualCost = vertex.actualCost + ActualCost( vertex, next);
+				next.heuristicCost = next.actualCost;
+				path.push_back( next);
+				vertex = next;
+			}
+		}
+		return path;
+	}
+} // namespace PathAlgorithm
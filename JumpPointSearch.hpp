@@ -0,0 +1,79 @@
+#ifndef JUMPPOINTSEARCH_HPP_
+#define JUMPPOINTSEARCH_HPP_
+
+#include "Config.hpp"
+
+#include "AStar.hpp"
+#include "OccupancyGrid.hpp"
+
+namespace PathAlgorithm
+{
+	/**
+	 * Jump Point Search (Harabor and Grastien, 2011) on the same 8-connected uniform-cost grid
+	 * as AStar. Instead of adding every neighbour to the openSet it jumps along straight and
+	 * diagonal lines until it finds a cell with a forced neighbour, so only those jump points are
+	 * expanded. The resulting route is just as short as the AStar route.
+	 *
+	 * As Robot::drive expects a route with one vertex per cell the segments between the jump
+	 * points are filled in before the path is returned.
+	 */
+	class JumpPointSearch : public AStar
+	{
+		public:
+			using AStar::search;
+			/**
+			 *
+			 */
+			JumpPointSearch();
+			/**
+			 *
+			 */
+			virtual Path search(Vertex aStart,
+								const Vertex& aGoal,
+								const Size& aRobotSize);
+
+		private:
+			/**
+			 *
+			 */
+			bool isWalkable(	int anX,
+								int anY) const
+			{
+				++wallCheckCount;
+				return anX >= 0 && anY >= 0 && anX < width && anY < height && occupancyGrid->isFree( anX, anY);
+			}
+			/**
+			 * Adds the (pruned) directions to search from aVertex to aDirections
+			 *
+			 * @return the number of directions
+			 */
+			int getDirections(	const Vertex& aVertex,
+								unsigned int aParent,
+								int* anXDirections,
+								int* anYDirections) const;
+			/**
+			 * Walks from (anX,anY) in direction (aDX,aDY) until a jump point is found
+			 *
+			 * @return true if there is a jump point, which is returned in aJumpPoint
+			 */
+			bool jump(	int anX,
+						int anY,
+						int aDX,
+						int aDY,
+						const Vertex& aGoal,
+						Vertex& aJumpPoint) const;
+			/**
+			 * Fills in the cells between the consecutive jump points of aPath
+			 */
+			static Path interpolate( const Path& aPath);
+
+			OccupancyGridPtr occupancyGrid;
+			int width;
+			int height;
+			/**
+			 * The cells looked up by the jumps of the current expansion
+			 */
+			mutable unsigned long wallCheckCount;
+	}; // class JumpPointSearch
+} // namespace PathAlgorithm
+#endif // JUMPPOINTSEARCH_HPP_
@@ -0,0 +1,252 @@
+#include "Landmarks.hpp"
+#include "FlowField.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <limits>
+#include <map>
+#include <mutex>
+
+namespace PathAlgorithm
+{
+	namespace
+	{
+		const int xOffset[] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+		const int yOffset[] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+
+		/**
+		 * The tables of a radius: the last ones that were finished and the ones being computed.
+		 * The computation only touches the tables it makes, so an entry can be destroyed at any
+		 * time, the future waits for the computation to finish.
+		 */
+		struct Entry
+		{
+				LandmarksPtr landmarks;
+				std::future< LandmarksPtr > computation;
+		};
+		// struct Entry
+
+		std::mutex registryMutex;
+		std::map< int, Entry > registry;
+	} // namespace
+
+	/* static */ const std::uint16_t Landmarks::Unreachable;
+	/* static */ const unsigned int Landmarks::DefaultLandmarkCount;
+	/* static */ constexpr double Landmarks::MinimumStep;
+	/**
+	 *
+	 */
+	Landmarks::Landmarks(	const OccupancyGridPtr& anOccupancyGrid,
+							unsigned int aLandmarkCount) :
+								occupancyGrid( anOccupancyGrid),
+								width( anOccupancyGrid->getWidth()),
+								height( anOccupancyGrid->getHeight()),
+								wallRevision( anOccupancyGrid->getWallRevision())
+	{
+		std::size_t size = static_cast< std::size_t >(width) * static_cast< std::size_t >(height);
+
+		// The first landmark is the cell farthest from any cell of the largest region, the routes
+		// in the other regions only have the straight line
+		Point seed;
+		if (!findLargestRegion( seed))
+		{
+			return;
+		}
+		std::vector< double > cost;
+		ComputeCosts( *occupancyGrid, seed, width, height, cost);
+
+		// The cost from every cell to the nearest landmark so far, the next landmark is the
+		// reachable cell where it is highest
+		std::vector< double > nearest( cost);
+		std::vector< std::vector< std::uint16_t > > tables;
+		while (landmarks.size() < aLandmarkCount)
+		{
+			std::size_t farthest = size;
+			for (std::size_t i = 0; i < size; ++i)
+			{
+				if (nearest[i] != std::numeric_limits< double >::infinity() && (farthest == size || nearest[i] > nearest[farthest]))
+				{
+					farthest = i;
+				}
+			}
+			if (farthest == size || (!landmarks.empty() && nearest[farthest] == 0.0))
+			{
+				break;
+			}
+
+			Point landmark( static_cast< int >(farthest % static_cast< std::size_t >(width)), static_cast< int >(farthest / static_cast< std::size_t >(width)));
+			ComputeCosts( *occupancyGrid, landmark, width, height, cost);
+
+			double maximumCost = 0.0;
+			for (std::size_t i = 0; i < size; ++i)
+			{
+				if (cost[i] != std::numeric_limits< double >::infinity())
+				{
+					maximumCost = std::max( maximumCost, cost[i]);
+					nearest[i] = landmarks.empty() ? cost[i] : std::min( nearest[i], cost[i]);
+				}
+			}
+			double step = std::max( maximumCost / (Unreachable - 1), MinimumStep);
+
+			tables.push_back( std::vector< std::uint16_t >( size, Unreachable));
+			std::vector< std::uint16_t >& table = tables.back();
+			for (std::size_t i = 0; i < size; ++i)
+			{
+				if (cost[i] != std::numeric_limits< double >::infinity())
+				{
+					table[i] = static_cast< std::uint16_t >(std::min( std::floor( cost[i] / step), static_cast< double >(Unreachable - 1)));
+				}
+			}
+			landmarks.push_back( landmark);
+			steps.push_back( step);
+		}
+
+		costs.resize( size * landmarks.size());
+		for (std::size_t i = 0; i < size; ++i)
+		{
+			for (std::size_t l = 0; l < landmarks.size(); ++l)
+			{
+				costs[i * landmarks.size() + l] = tables[l][i];
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	/* static */ LandmarksPtr Landmarks::getLandmarks( int aRadius)
+	{
+		OccupancyGridPtr occupancyGrid = OccupancyGrid::getOccupancyGrid( aRadius);
+
+		std::lock_guard< std::mutex > lock( registryMutex);
+		Entry& entry = registry[aRadius];
+		if (entry.computation.valid() && entry.computation.wait_for( std::chrono::seconds( 0)) == std::future_status::ready)
+		{
+			entry.landmarks = entry.computation.get();
+		}
+		if (entry.landmarks && entry.landmarks->getWallRevision() == occupancyGrid->getWallRevision())
+		{
+			return entry.landmarks;
+		}
+		// One computation per radius at a time, the walls may have changed again by the time it
+		// finishes, in which case the next call starts another one
+		if (!entry.computation.valid())
+		{
+			entry.computation = std::async( std::launch::async, [occupancyGrid]()
+			{
+				return LandmarksPtr( std::make_shared< const Landmarks >( occupancyGrid));
+			});
+		}
+		return LandmarksPtr();
+	}
+	/**
+	 *
+	 */
+	double Landmarks::getLowerBound(	int aFromX,
+										int aFromY,
+										int aToX,
+										int aToY) const
+	{
+		if (!contains( aFromX, aFromY) || !contains( aToX, aToY))
+		{
+			return 0.0;
+		}
+		const std::uint16_t* from = &costs[static_cast< std::size_t >(aFromY * width + aFromX) * landmarks.size()];
+		const std::uint16_t* to = &costs[static_cast< std::size_t >(aToY * width + aToX) * landmarks.size()];
+
+		// The stored costs are rounded down, the true difference may be one unit less
+		double lowerBound = 0.0;
+		for (std::size_t l = 0; l < landmarks.size(); ++l)
+		{
+			if (from[l] != Unreachable && to[l] != Unreachable)
+			{
+				int difference = std::abs( static_cast< int >(from[l]) - static_cast< int >(to[l])) - 1;
+				lowerBound = std::max( lowerBound, difference * steps[l]);
+			}
+		}
+		return lowerBound;
+	}
+	/**
+	 *
+	 */
+	bool Landmarks::findLargestRegion( Point& aCell) const
+	{
+		std::size_t size = static_cast< std::size_t >(width) * static_cast< std::size_t >(height);
+		std::vector< bool > labelled( size, false);
+		std::vector< unsigned int > region;
+		std::size_t largestSize = 0;
+		for (std::size_t first = 0; first < size; ++first)
+		{
+			int firstX = static_cast< int >(first % static_cast< std::size_t >(width));
+			int firstY = static_cast< int >(first / static_cast< std::size_t >(width));
+			if (labelled[first] || !occupancyGrid->isFree( firstX, firstY))
+			{
+				continue;
+			}
+
+			// A flood fill, the region doubles as the stack
+			region.assign( 1, static_cast< unsigned int >(first));
+			labelled[first] = true;
+			for (std::size_t i = 0; i < region.size(); ++i)
+			{
+				int x = static_cast< int >(region[i] % static_cast< unsigned int >(width));
+				int y = static_cast< int >(region[i] / static_cast< unsigned int >(width));
+				for (int d = 0; d < 8; ++d)
+				{
+					int neighbourX = x + xOffset[d];
+					int neighbourY = y + yOffset[d];
+					if (!contains( neighbourX, neighbourY))
+					{
+						continue;
+					}
+					unsigned int neighbourIndex = static_cast< unsigned int >(neighbourY * width + neighbourX);
+					if (!labelled[neighbourIndex] && occupancyGrid->isFree( neighbourX, neighbourY))
+					{
+						labelled[neighbourIndex] = true;
+						region.push_back( neighbourIndex);
+					}
+				}
+			}
+			OccupancyGrid::countWallChecks( region.size() * 8);
+
+			if (region.size() > largestSize)
+			{
+				largestSize = region.size();
+				aCell = Point( firstX, firstY);
+			}
+		}
+		OccupancyGrid::countWallChecks( size);
+		return largestSize > 0;
+	}
+	/**
+	 *
+	 */
+	Path LandmarkAStar::search(	Vertex aStart,
+								const Vertex& aGoal,
+								const Size& aRobotSize)
+	{
+		// A search that leaves the tables could take routes around them that they do not know
+		landmarks = Landmarks::getLandmarks( FreeRadius( aRobotSize));
+		if (landmarks && (!landmarks->contains( aStart.x, aStart.y) || !landmarks->contains( aGoal.x, aGoal.y)))
+		{
+			landmarks.reset();
+		}
+		return AStar::search( aStart, aGoal, aRobotSize);
+	}
+	/**
+	 *
+	 */
+	double LandmarkAStar::estimateCost(	const Vertex& aVertex,
+										const Vertex& aGoal) const
+	{
+		// The cost of the route without walls, as straight and diagonal steps
+		int dx = std::abs( aVertex.x - aGoal.x);
+		int dy = std::abs( aVertex.y - aGoal.y);
+		double estimate = std::max( dx, dy) + (DiagonalStepCost - 1.0) * std::min( dx, dy);
+		if (landmarks)
+		{
+			estimate = std::max( estimate, landmarks->getLowerBound( aVertex.x, aVertex.y, aGoal.x, aGoal.y));
+		}
+		return estimate;
+	}
+} // namespace PathAlgorithm
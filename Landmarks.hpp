@@ -0,0 +1,151 @@
+#ifndef LANDMARKS_HPP_
+#define LANDMARKS_HPP_
+
+#include "Config.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "AStar.hpp"
+#include "OccupancyGrid.hpp"
+
+namespace PathAlgorithm
+{
+	class Landmarks;
+	typedef std::shared_ptr< const Landmarks > LandmarksPtr;
+
+	/**
+	 * The tables of the ALT heuristic (A*, Landmarks, Triangle inequality; Goldberg and Harrelson,
+	 * 2005) for the occupancy grid of a radius: the cost of the route of every cell to a few
+	 * landmarks. For every landmark L the cost of the route from n to g is at least
+	 * |d(L, g) - d(L, n)|, which is a far better estimate than the straight line wherever the walls
+	 * force a detour.
+	 *
+	 * The landmarks are picked one after the other as the cell farthest from the landmarks picked
+	 * before, so they end up in the corners and dead ends of the world. The costs are stored as
+	 * 16-bit multiples of a step per landmark, the landmarks of a cell next to each other, so a
+	 * lookup reads a single cache line. A grid of 500 by 500 cells takes 8 MB with 16 landmarks.
+	 *
+	 * The tables are made for one wall revision and are never changed. After the walls changed
+	 * new tables are computed in the background, searches do not wait for them.
+	 */
+	class Landmarks
+	{
+		public:
+			/**
+			 * The cost of a cell that can not reach the landmark
+			 */
+			static const std::uint16_t Unreachable = 0xFFFF;
+			/**
+			 *
+			 */
+			static const unsigned int DefaultLandmarkCount = 16;
+			/**
+			 * The finest step the costs are stored in
+			 */
+			static constexpr double MinimumStep = 1.0 / 16.0;
+			/**
+			 * Picks aLandmarkCount landmarks on anOccupancyGrid and computes their tables, fewer if
+			 * the landmarks run out of distinct cells
+			 */
+			explicit Landmarks(	const OccupancyGridPtr& anOccupancyGrid,
+								unsigned int aLandmarkCount = DefaultLandmarkCount);
+			/**
+			 * @return the tables for aRadius in the current wall revision, nullptr if they are not
+			 * computed yet. If they are not, their computation is started in the background.
+			 */
+			static LandmarksPtr getLandmarks( int aRadius);
+			/**
+			 * @return a lower bound of the cost of the route from (aFromX, aFromY) to (aToX, aToY),
+			 * 0 if the tables know nothing about one of them
+			 */
+			double getLowerBound(	int aFromX,
+									int aFromY,
+									int aToX,
+									int aToY) const;
+			/**
+			 *
+			 */
+			bool contains(	int anX,
+							int anY) const
+			{
+				return anX >= 0 && anY >= 0 && anX < width && anY < height;
+			}
+			/**
+			 *
+			 */
+			const std::vector< Point >& getLandmarkPoints() const
+			{
+				return landmarks;
+			}
+			/**
+			 *
+			 */
+			unsigned long getWallRevision() const
+			{
+				return wallRevision;
+			}
+			/**
+			 *
+			 */
+			std::size_t getAllocatedBytes() const
+			{
+				return costs.capacity() * sizeof( std::uint16_t) + steps.capacity() * sizeof( double);
+			}
+
+		private:
+			/**
+			 * Sets aCell to a cell of the largest region of free cells that are connected to each
+			 * other
+			 *
+			 * @return false if there are no free cells
+			 */
+			bool findLargestRegion( Point& aCell) const;
+
+			OccupancyGridPtr occupancyGrid;
+			int width;
+			int height;
+			unsigned long wallRevision;
+
+			std::vector< Point > landmarks;
+			/**
+			 * The cost one unit of a table stands for, per landmark
+			 */
+			std::vector< double > steps;
+			/**
+			 * Per cell the costs of the landmarks in units of their step
+			 */
+			std::vector< std::uint16_t > costs;
+	}; // class Landmarks
+
+	/**
+	 * AStar with the maximum of the octile distance and the Landmarks bound as its heuristic.
+	 * Until the tables of the current walls are computed only the octile distance is used.
+	 */
+	class LandmarkAStar : public AStar
+	{
+		public:
+			using AStar::search;
+			/**
+			 *
+			 */
+			virtual Path search(Vertex aStart,
+								const Vertex& aGoal,
+								const Size& aRobotSize);
+
+		protected:
+			/**
+			 *
+			 */
+			virtual double estimateCost(	const Vertex& aVertex,
+											const Vertex& aGoal) const;
+
+		private:
+			/**
+			 * The tables of the current search, nullptr if there are none
+			 */
+			LandmarksPtr landmarks;
+	}; // class LandmarkAStar
+} // namespace PathAlgorithm
+#endif // LANDMARKS_HPP_
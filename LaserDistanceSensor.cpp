@@ -8,6 +8,8 @@
 #include "LaserDistanceSensor.hpp"
 #include "Robot.hpp"
 #include "Logger.hpp"
+#include "DistanceField.hpp"
+#include "Shape2DUtils.hpp"
 
 namespace Model
 {
@@ -36,7 +38,16 @@ namespace Model
 	 */
 	std::shared_ptr< AbstractStimulus > LaserDistanceSensor::getStimulus() const
 	{
-		std::shared_ptr< AbstractStimulus > distanceStimulus( new DistanceStimulus( 666,666));
+		Robot* robot = dynamic_cast< Robot* >( agent);
+		if (!robot)
+		{
+			return std::shared_ptr< AbstractStimulus >( new DistanceStimulus( 0, MaximumRange));
+		}
+
+		// The beam leaves the centre of the robot in the direction it is facing
+		double angle = Utils::Shape2DUtils::getAngle( robot->getFront());
+		double distance = PathAlgorithm::DistanceField::getDistanceField()->castRay( robot->getPosition(), angle, MaximumRange);
+		std::shared_ptr< AbstractStimulus > distanceStimulus( new DistanceStimulus( angle, distance));
 		return distanceStimulus;
 	}
 	/**
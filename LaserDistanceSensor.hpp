@@ -62,6 +62,10 @@ namespace Model
 	class LaserDistanceSensor : public AbstractSensor
 	{
 		public:
+			/**
+			 * The distance reported when the beam hits no wall
+			 */
+			static constexpr double MaximumRange = 1024.0;
 			/**
 			 *
 			 */
@@ -3,6 +3,7 @@
 
 #include "Config.hpp"
 
+#include <atomic>
 #include <string>
 
 namespace Application
@@ -22,6 +23,8 @@ namespace Application
 			/**
 			 *
 			 * Disable/enable the logger. Called with true (default) enables the logger, with false disables the logger.
+			 * The logger is shared by all threads, so this is meant for the user, not to silence a
+			 * single thread for a while.
 			 *
 			 * @param aDisable, by default true
 			 */
@@ -38,7 +41,7 @@ namespace Application
 			 *
 			 */
 		private:
-			static bool disable;
+			static std::atomic< bool > disable;
 	};
 } // namespace Application
 #endif /* LOGGER_HPP_ */
@@ -308,6 +308,12 @@ Panel *MainFrameWindow::initialiseButtonPanel()
 			   GBPosition(2, 1),
 			   GBSpan(1, 1), EXPAND);
 
+	sizer->Add(makeButton(panel,
+						  "Start robots",
+						  [this](CommandEvent &anEvent) { this->OnStartRobots(anEvent); }),
+			   GBPosition(2, 3),
+			   GBSpan(1, 1), EXPAND);
+
 	sizer->Add(makeButton(panel, "Copy World",
 						  [this](CommandEvent &anEvent) { this->OnCopyWorld(anEvent); }),
 			   GBPosition(1, 0), GBSpan(1, 1), EXPAND);
@@ -327,6 +333,7 @@ Panel *MainFrameWindow::initialiseButtonPanel()
 	 */
 void MainFrameWindow::OnQuit(CommandEvent &UNUSEDPARAM(anEvent))
 {
+	Model::RobotWorld::getRobotWorld().logSearchStatistics();
 	Close(true);
 }
 /**
@@ -412,6 +419,15 @@ void MainFrameWindow::OnStopRobot(CommandEvent &UNUSEDPARAM(anEvent))
 		}
 	}
 }
+/**
+	 *
+	 */
+void MainFrameWindow::OnStartRobots(CommandEvent &UNUSEDPARAM(anEvent))
+{
+	Logger::log("Planning the routes of all robots...");
+
+	Model::RobotWorld::getRobotWorld().startRobots();
+}
 /**
 	 *
 	 */
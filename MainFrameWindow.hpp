@@ -91,6 +91,7 @@ private:
 
 	void OnStartRobot(CommandEvent &anEvent);
 	void OnStopRobot(CommandEvent &anEvent);
+	void OnStartRobots(CommandEvent &anEvent);
 	void OnPopulate(CommandEvent &anEvent);
 	void scenario_1_lhs(CommandEvent &(anEvent));
 	void scenario_1_rhs(CommandEvent &(anEvent));
@@ -0,0 +1,98 @@
+#ifndef MPSCQUEUE_HPP_
+#define MPSCQUEUE_HPP_
+
+#include "Config.hpp"
+
+#include <atomic>
+#include <utility>
+
+namespace Base
+{
+	/**
+	 * A lock-free queue for many producers and a single consumer (Vyukov): a producer swaps its
+	 * node in as the new head and then links the previous head to it, the consumer follows the
+	 * links from the tail. An element whose producer has swapped but not yet linked it is not
+	 * dequeued until it is linked, the elements of one producer are dequeued in order.
+	 *
+	 * Every element is a node on the heap, enqueue batches rather than single elements.
+	 */
+	template< typename QueueContentType >
+	class MpscQueue
+	{
+		public:
+			/**
+			 *
+			 */
+			MpscQueue() :
+							head( &stub),
+							tail( &stub)
+			{
+				stub.next.store( nullptr, std::memory_order_relaxed);
+			}
+			/**
+			 *
+			 */
+			~MpscQueue()
+			{
+				QueueContentType element;
+				while (dequeue( element))
+				{
+				}
+				if (tail != &stub)
+				{
+					delete tail;
+				}
+			}
+			/**
+			 * May be called by any thread
+			 */
+			void enqueue( QueueContentType anElement)
+			{
+				Node* node = new Node;
+				node->element = std::move( anElement);
+				node->next.store( nullptr, std::memory_order_relaxed);
+				Node* previous = head.exchange( node, std::memory_order_acq_rel);
+				previous->next.store( node, std::memory_order_release);
+			}
+			/**
+			 * May only be called by the consumer
+			 *
+			 * @return false if there is no element, or the next one is not linked yet
+			 */
+			bool dequeue( QueueContentType& anElement)
+			{
+				Node* next = tail->next.load( std::memory_order_acquire);
+				if (next == nullptr)
+				{
+					return false;
+				}
+				anElement = std::move( next->element);
+				// The node of the element becomes the new dummy at the tail
+				if (tail != &stub)
+				{
+					delete tail;
+				}
+				tail = next;
+				return true;
+			}
+
+		private:
+			/**
+			 *
+			 */
+			struct Node
+			{
+					std::atomic< Node* > next;
+					QueueContentType element;
+			};
+			// struct Node
+
+			MpscQueue( const MpscQueue&) = delete;
+			MpscQueue& operator=( const MpscQueue&) = delete;
+
+			Node stub;
+			std::atomic< Node* > head;
+			Node* tail;
+	}; // class MpscQueue
+} // namespace Base
+#endif // MPSCQUEUE_HPP_
@@ -0,0 +1,173 @@
+#include "OccupancyGrid.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+
+namespace PathAlgorithm
+{
+	/* static */ thread_local unsigned long OccupancyGrid::wallCheckCount = 0;
+	/* static */ thread_local OccupancyGridPtr OccupancyGrid::pinnedGrid;
+	/**
+	 *
+	 */
+	OccupancyGrid::Pin::Pin( const OccupancyGridPtr& anOccupancyGrid) :
+								previousGrid( pinnedGrid)
+	{
+		pinnedGrid = anOccupancyGrid;
+	}
+	/**
+	 *
+	 */
+	OccupancyGrid::Pin::~Pin()
+	{
+		pinnedGrid = previousGrid;
+	}
+	/**
+	 *
+	 */
+	OccupancyGrid::OccupancyGrid( int aRadius) :
+								radius( aRadius),
+								width( 0),
+								height( 0),
+								wallRevision( static_cast< unsigned long >(-1))
+	{
+	}
+	/**
+	 *
+	 */
+	/* static */ OccupancyGridPtr OccupancyGrid::getOccupancyGrid( int aRadius)
+	{
+		static std::mutex registryMutex;
+		static std::map< int, std::shared_ptr< OccupancyGrid > > registry;
+
+		if (pinnedGrid && pinnedGrid->getRadius() == aRadius)
+		{
+			return pinnedGrid;
+		}
+		DistanceFieldPtr distanceField = pinnedGrid ? pinnedGrid->getDistanceField() : DistanceField::getDistanceField();
+
+		std::lock_guard< std::mutex > lock( registryMutex);
+
+		std::shared_ptr< OccupancyGrid >& grid = registry[aRadius];
+		if (!grid)
+		{
+			grid = std::make_shared< OccupancyGrid >( aRadius);
+		}
+		if (grid->getWallRevision() != distanceField->getWallRevision())
+		{
+			if (pinnedGrid)
+			{
+				// The registry follows the RobotWorld, a grid of the pinned revision is not shared
+				std::shared_ptr< OccupancyGrid > pinnedRevisionGrid = std::make_shared< OccupancyGrid >( aRadius);
+				pinnedRevisionGrid->synchronise( distanceField);
+				return pinnedRevisionGrid;
+			}
+			// Searches that still use the grid must not see it change
+			if (grid.use_count() > 1)
+			{
+				grid = std::make_shared< OccupancyGrid >( *grid);
+			}
+			grid->synchronise( distanceField);
+		}
+		return grid;
+	}
+	/**
+	 *
+	 */
+	void OccupancyGrid::synchronise( const DistanceFieldPtr& aDistanceField)
+	{
+		// The field extends MaximumDistance beyond the walls, the grid only the radius
+		int requiredWidth = std::max( aDistanceField->getWidth() - DistanceField::MaximumDistance + radius, 0);
+		int requiredHeight = std::max( aDistanceField->getHeight() - DistanceField::MaximumDistance + radius, 0);
+
+		if (requiredWidth > width || requiredHeight > height)
+		{
+			resize( std::max( requiredWidth, width), std::max( requiredHeight, height));
+			threshold( *aDistanceField, DistanceField::Region { 0, 0, width - 1, height - 1 });
+		} else
+		{
+			threshold( *aDistanceField, aDistanceField->getChangedRegion( wallRevision));
+		}
+
+		distanceField = aDistanceField;
+		wallRevision = aDistanceField->getWallRevision();
+	}
+	/**
+	 *
+	 */
+	void OccupancyGrid::threshold(	const DistanceField& aDistanceField,
+									const DistanceField::Region& aRegion)
+	{
+		int maxX = std::min( aRegion.maxX, width - 1);
+		int maxY = std::min( aRegion.maxY, height - 1);
+		for (int y = std::max( aRegion.minY, 0); y <= maxY; ++y)
+		{
+			for (int x = std::max( aRegion.minX, 0); x <= maxX; ++x)
+			{
+				occupied[static_cast< std::size_t >(y * width + x)] = !aDistanceField.isFree( x, y, radius);
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	bool OccupancyGrid::isLineFree(	const Point& aFrom,
+									const Point& aTo) const
+	{
+		int dx = std::abs( aTo.x - aFrom.x);
+		int dy = std::abs( aTo.y - aFrom.y);
+		int stepX = aTo.x > aFrom.x ? 1 : -1;
+		int stepY = aTo.y > aFrom.y ? 1 : -1;
+
+		// Walk the cells in the order the line enters them, comparing where the line crosses the
+		// next vertical and the next horizontal cell border
+		int x = aFrom.x;
+		int y = aFrom.y;
+		unsigned long checks = 0;
+		bool free = true;
+		for (int ix = 0, iy = 0; ix < dx || iy < dy;)
+		{
+			long long decision = static_cast< long long >(1 + 2 * ix) * dy - static_cast< long long >(1 + 2 * iy) * dx;
+			if (decision == 0)
+			{
+				checks += 2;
+				if (!isFree( x + stepX, y) || !isFree( x, y + stepY))
+				{
+					free = false;
+					break;
+				}
+				x += stepX;
+				y += stepY;
+				++ix;
+				++iy;
+			} else if (decision < 0)
+			{
+				x += stepX;
+				++ix;
+			} else
+			{
+				y += stepY;
+				++iy;
+			}
+			++checks;
+			if (!isFree( x, y))
+			{
+				free = false;
+				break;
+			}
+		}
+		countWallChecks( checks);
+		return free;
+	}
+	/**
+	 *
+	 */
+	void OccupancyGrid::resize(	int aWidth,
+								int aHeight)
+	{
+		width = aWidth;
+		height = aHeight;
+		occupied.assign( static_cast< std::size_t >(width) * static_cast< std::size_t >(height), false);
+	}
+} // namespace PathAlgorithm
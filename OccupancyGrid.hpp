@@ -0,0 +1,175 @@
+#ifndef OCCUPANCYGRID_HPP_
+#define OCCUPANCYGRID_HPP_
+
+#include "Config.hpp"
+
+#include <memory>
+#include <vector>
+
+#include "DistanceField.hpp"
+#include "Point.hpp"
+
+namespace PathAlgorithm
+{
+	class OccupancyGrid;
+	typedef std::shared_ptr< const OccupancyGrid > OccupancyGridPtr;
+
+	/**
+	 * The configuration space of a round robot with a given radius: a cell is occupied if a robot
+	 * centred on it would be within the radius of a wall. The grid is the DistanceField thresholded
+	 * at the radius, so a collision test in the inner loops of the searches stays a single bit test
+	 * while the walls are only rasterised and transformed once for all radii.
+	 *
+	 * When the field changed since the previous synchronisation only its changed region is
+	 * thresholded again. Radii up to DistanceField::MaximumDistance are supported.
+	 *
+	 * Cells outside the grid are not covered by any wall and therefore free.
+	 */
+	class OccupancyGrid
+	{
+		public:
+			/**
+			 * While a Pin lives the thread that made it gets the grids of the wall revision of the
+			 * pinned grid from getOccupancyGrid, without looking at the RobotWorld: the pinned grid
+			 * for its own radius and a grid thresholded from its DistanceField for the other radii.
+			 */
+			class Pin
+			{
+				public:
+					/**
+					 *
+					 */
+					explicit Pin( const OccupancyGridPtr& anOccupancyGrid);
+					/**
+					 * Restores the grid that was pinned before
+					 */
+					~Pin();
+
+				private:
+					Pin( const Pin&) = delete;
+					Pin& operator=( const Pin&) = delete;
+
+					OccupancyGridPtr previousGrid;
+			}; // class Pin
+			/**
+			 *
+			 */
+			explicit OccupancyGrid( int aRadius);
+			/**
+			 * @return the grid for aRadius that is synchronised with the current wall revision of the
+			 * RobotWorld, or with the grid pinned by the calling thread. Grids are shared between
+			 * searches, a returned grid is never changed anymore.
+			 */
+			static OccupancyGridPtr getOccupancyGrid( int aRadius);
+			/**
+			 * Brings the grid in line with aDistanceField
+			 */
+			void synchronise( const DistanceFieldPtr& aDistanceField);
+			/**
+			 *
+			 */
+			bool isFree(	int anX,
+							int anY) const
+			{
+				return !contains( anX, anY) || !occupied[static_cast< std::size_t >(anY * width + anX)];
+			}
+			/**
+			 *
+			 */
+			bool isFree( const Point& aPoint) const
+			{
+				return isFree( aPoint.x, aPoint.y);
+			}
+			/**
+			 * @return true if every cell the straight line from aFrom to aTo passes through is free,
+			 * aFrom itself is not tested. Where the line passes exactly through the corner of a cell
+			 * both cells beside the corner must be free.
+			 */
+			bool isLineFree(	const Point& aFrom,
+								const Point& aTo) const;
+			/**
+			 *
+			 */
+			bool contains(	int anX,
+							int anY) const
+			{
+				return anX >= 0 && anY >= 0 && anX < width && anY < height;
+			}
+			/**
+			 * @return the number of cells the calling thread looked up since it started, the
+			 * difference before and after a search is the number of wall checks of the search
+			 */
+			static unsigned long getWallCheckCount()
+			{
+				return wallCheckCount;
+			}
+			/**
+			 * Counts aCount cells looked up by the calling thread. isFree does not count itself, that
+			 * would cost too much in the inner loops, the searches count per expansion, line or scan.
+			 */
+			static void countWallChecks( unsigned long aCount)
+			{
+				wallCheckCount += aCount;
+			}
+			/**
+			 *
+			 */
+			int getRadius() const
+			{
+				return radius;
+			}
+			/**
+			 *
+			 */
+			int getWidth() const
+			{
+				return width;
+			}
+			/**
+			 *
+			 */
+			int getHeight() const
+			{
+				return height;
+			}
+			/**
+			 *
+			 */
+			unsigned long getWallRevision() const
+			{
+				return wallRevision;
+			}
+			/**
+			 * @return the field the grid was thresholded from, for the clearance of a cell beyond the
+			 * free or occupied of the grid
+			 */
+			const DistanceFieldPtr& getDistanceField() const
+			{
+				return distanceField;
+			}
+
+		private:
+			/**
+			 * Thresholds the cells of aRegion of aDistanceField
+			 */
+			void threshold(	const DistanceField& aDistanceField,
+							const DistanceField::Region& aRegion);
+			/**
+			 *
+			 */
+			void resize(	int aWidth,
+							int aHeight);
+
+			int radius;
+			int width;
+			int height;
+			unsigned long wallRevision;
+
+			DistanceFieldPtr distanceField;
+			std::vector< bool > occupied;
+
+			static thread_local unsigned long wallCheckCount;
+			static thread_local OccupancyGridPtr pinnedGrid;
+	}; // class OccupancyGrid
+} // namespace PathAlgorithm
+#endif // OCCUPANCYGRID_HPP_
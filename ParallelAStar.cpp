@@ -0,0 +1,356 @@
+#include "ParallelAStar.hpp"
+#include "MpscQueue.hpp"
+#include "OccupancyGrid.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <thread>
+
+namespace PathAlgorithm
+{
+	namespace
+	{
+		const unsigned int NoParent = std::numeric_limits< unsigned int >::max();
+		/**
+		 * The termination word: the number of active workers in the upper half, the number of
+		 * batches that were sent but not handled yet in the lower half
+		 */
+		const std::uint64_t ActiveWorker = std::uint64_t( 1) << 32;
+		/**
+		 * The number of expansions between two looks at the inbox
+		 */
+		const int ExpansionsPerRound = 64;
+
+		/**
+		 * A route to a cell, for the owner of the cell
+		 */
+		struct Message
+		{
+				unsigned int cell;
+				unsigned int parent;
+				double actualCost;
+		};
+		// struct Message
+		typedef std::vector< Message > Batch;
+	} // namespace
+
+	/**
+	 *
+	 */
+	struct ParallelAStar::Search
+	{
+			/**
+			 *
+			 */
+			Search(	const OccupancyGrid& anOccupancyGrid,
+					const Size& aBounds,
+					const Vertex& aGoal,
+					unsigned int aWorkerCount,
+					std::vector< double >& anActualCosts,
+					std::vector< unsigned int >& aParents) :
+						occupancyGrid( anOccupancyGrid),
+						width( aBounds.x),
+						height( aBounds.y),
+						goal( aGoal),
+						goalCell( static_cast< unsigned int >(aGoal.y * aBounds.x + aGoal.x)),
+						workerCount( aWorkerCount),
+						actualCosts( anActualCosts),
+						parents( aParents),
+						activity( aWorkerCount * ActiveWorker),
+						incumbent( std::numeric_limits< double >::infinity()),
+						cancelled( false),
+						expansionCount( 0),
+						wallCheckCount( 0)
+			{
+				for (unsigned int i = 0; i < workerCount; ++i)
+				{
+					inboxes.push_back( std::unique_ptr< Base::MpscQueue< Batch > >( new Base::MpscQueue< Batch >));
+				}
+			}
+			/**
+			 *
+			 */
+			unsigned int ownerOf( unsigned int aCell) const
+			{
+				unsigned long long tile = (static_cast< unsigned long long >((aCell / static_cast< unsigned int >(width)) / TileSize) << 32) | ((aCell % static_cast< unsigned int >(width)) / TileSize);
+				return static_cast< unsigned int >(((tile * 0x9E3779B97F4A7C15ULL) >> 32) % workerCount);
+			}
+			/**
+			 *
+			 */
+			double estimateCost( unsigned int aCell) const
+			{
+				double dx = static_cast< int >(aCell % static_cast< unsigned int >(width)) - goal.x;
+				double dy = static_cast< int >(aCell / static_cast< unsigned int >(width)) - goal.y;
+				return std::sqrt( dx * dx + dy * dy);
+			}
+			/**
+			 *
+			 */
+			void send(	unsigned int aWorker,
+						Batch& aBatch)
+			{
+				// Counted before it is underway, so the search can not end before it is handled
+				activity.fetch_add( 1);
+				inboxes[aWorker]->enqueue( std::move( aBatch));
+				aBatch = Batch();
+			}
+			/**
+			 * Lowers the incumbent to aCost unless it is already lower
+			 */
+			void improveIncumbent( double aCost)
+			{
+				double current = incumbent.load();
+				while (aCost < current && !incumbent.compare_exchange_weak( current, aCost))
+				{
+				}
+			}
+
+			const OccupancyGrid& occupancyGrid;
+			int width;
+			int height;
+			Vertex goal;
+			unsigned int goalCell;
+			unsigned int workerCount;
+			std::vector< double >& actualCosts;
+			std::vector< unsigned int >& parents;
+			std::vector< std::unique_ptr< Base::MpscQueue< Batch > > > inboxes;
+
+			std::atomic< std::uint64_t > activity;
+			/**
+			 * The cost of the cheapest route to the goal found so far
+			 */
+			std::atomic< double > incumbent;
+			std::atomic< bool > cancelled;
+			std::atomic< unsigned long > expansionCount;
+			std::atomic< unsigned long > wallCheckCount;
+	};
+	// struct ParallelAStar::Search
+
+	/* static */ const int ParallelAStar::TileSize;
+	/* static */ const std::size_t ParallelAStar::BatchSize;
+	/**
+	 *
+	 */
+	ParallelAStar::ParallelAStar( unsigned int aThreadCount /* = 0 */) :
+								threadCount( 0)
+	{
+		setThreadCount( aThreadCount);
+	}
+	/**
+	 *
+	 */
+	void ParallelAStar::setThreadCount( unsigned int aThreadCount)
+	{
+		threadCount = aThreadCount != 0 ? aThreadCount : std::max( 1u, std::thread::hardware_concurrency());
+	}
+	/**
+	 *
+	 */
+	Path ParallelAStar::search(	Vertex aStart,
+								const Vertex& aGoal,
+								const Size& aRobotSize)
+	{
+		if (threadCount < 2)
+		{
+			return AStar::search( aStart, aGoal, aRobotSize);
+		}
+
+		OccupancyGridPtr occupancyGrid = OccupancyGrid::getOccupancyGrid( FreeRadius( aRobotSize));
+		Size bounds = WorldBounds( aStart, aGoal, *occupancyGrid);
+		if (aStart.x < 0 || aStart.y < 0 || aGoal.x < 0 || aGoal.y < 0)
+		{
+			std::cerr << "**** No route from " << aStart << " to " << aGoal << ": outside of the world" << std::endl;
+			return Path();
+		}
+
+		actualCosts.assign( static_cast< std::size_t >(bounds.x) * static_cast< std::size_t >(bounds.y), std::numeric_limits< double >::infinity());
+		parents.resize( actualCosts.size());
+
+		Search search( *occupancyGrid, bounds, aGoal, threadCount, actualCosts, parents);
+		unsigned int startCell = static_cast< unsigned int >(aStart.y * bounds.x + aStart.x);
+		Batch start( 1, Message { startCell, NoParent, 0.0 });
+		search.send( search.ownerOf( startCell), start);
+
+		// The calling thread is the first worker
+		std::vector< std::thread > workers;
+		for (unsigned int worker = 1; worker < threadCount; ++worker)
+		{
+			workers.push_back( std::thread( [this, &search, worker]()
+			{
+				unsigned long wallCheckCount = OccupancyGrid::getWallCheckCount();
+				work( search, worker);
+				search.wallCheckCount.fetch_add( OccupancyGrid::getWallCheckCount() - wallCheckCount);
+			}));
+		}
+		work( search, 0);
+		for (std::thread& worker : workers)
+		{
+			worker.join();
+		}
+
+		countExpansions( search.expansionCount.load());
+		OccupancyGrid::countWallChecks( search.wallCheckCount.load());
+		if (search.cancelled.load())
+		{
+			throw SearchCancelled();
+		}
+		if (std::isinf( search.incumbent.load()))
+		{
+			std::cerr << "**** No route from " << aStart << " to " << aGoal << std::endl;
+			return Path();
+		}
+
+		Path path;
+		for (unsigned int cell = search.goalCell; cell != NoParent; cell = parents[cell])
+		{
+			Vertex vertex( static_cast< int >(cell % static_cast< unsigned int >(bounds.x)), static_cast< int >(cell / static_cast< unsigned int >(bounds.x)));
+			vertex.actualCost = vertex.heuristicCost = actualCosts[cell];
+			path.push_back( vertex);
+		}
+		std::reverse( path.begin(), path.end());
+		return path;
+	}
+	/**
+	 *
+	 */
+	std::size_t ParallelAStar::getAllocatedBytes() const
+	{
+		return AStar::getAllocatedBytes() + actualCosts.capacity() * sizeof( double) + parents.capacity() * sizeof( unsigned int);
+	}
+	/**
+	 *
+	 */
+	void ParallelAStar::work(	Search& aSearch,
+								unsigned int aWorker) const
+	{
+		std::priority_queue< OpenEntry< unsigned int >, std::vector< OpenEntry< unsigned int > >, OpenEntryGreater > openCells;
+		std::vector< Batch > outboxes( aSearch.workerCount);
+		unsigned long expandedCount = 0;
+
+		auto relax = [&]( const Message& aMessage)
+		{
+			double& actualCost = aSearch.actualCosts[aMessage.cell];
+			if (aMessage.actualCost >= actualCost)
+			{
+				return;
+			}
+			actualCost = aMessage.actualCost;
+			aSearch.parents[aMessage.cell] = aMessage.parent;
+			double heuristicCost = aMessage.actualCost + aSearch.estimateCost( aMessage.cell);
+			if (heuristicCost < aSearch.incumbent.load( std::memory_order_relaxed))
+			{
+				openCells.push( OpenEntry< unsigned int > { heuristicCost, aMessage.actualCost, aMessage.cell });
+			}
+		};
+		// Drops the entries that were improved upon after they were queued, true if the first
+		// entry left may still lead to a cheaper route to the goal
+		auto hasWork = [&]()
+		{
+			while (!openCells.empty() && openCells.top().actualCost > aSearch.actualCosts[openCells.top().index])
+			{
+				openCells.pop();
+			}
+			return !openCells.empty() && openCells.top().heuristicCost < aSearch.incumbent.load( std::memory_order_relaxed);
+		};
+
+		bool active = true;
+		Base::MpscQueue< Batch >& inbox = *aSearch.inboxes[aWorker];
+		while (!aSearch.cancelled.load( std::memory_order_relaxed))
+		{
+			Batch batch;
+			while (inbox.dequeue( batch))
+			{
+				if (!active)
+				{
+					// Active again before the batch stops counting
+					aSearch.activity.fetch_add( ActiveWorker);
+					active = true;
+				}
+				for (const Message& message : batch)
+				{
+					relax( message);
+				}
+				aSearch.activity.fetch_sub( 1);
+			}
+
+			for (int i = 0; i < ExpansionsPerRound && hasWork(); ++i)
+			{
+				OpenEntry< unsigned int > current = openCells.top();
+				openCells.pop();
+				if (++expandedCount % CancellationInterval == 0 && isCancelled())
+				{
+					aSearch.cancelled.store( true);
+					break;
+				}
+
+				if (current.index == aSearch.goalCell)
+				{
+					aSearch.improveIncumbent( current.actualCost);
+					continue;
+				}
+
+				int x = static_cast< int >(current.index % static_cast< unsigned int >(aSearch.width));
+				int y = static_cast< int >(current.index / static_cast< unsigned int >(aSearch.width));
+				Neighbours neighbours;
+				GetNeighbours( Vertex( x, y), aSearch.occupancyGrid, neighbours);
+				for (const Neighbour& candidate : neighbours)
+				{
+					if (candidate.x < 0 || candidate.y < 0 || candidate.x >= aSearch.width || candidate.y >= aSearch.height)
+					{
+						continue;
+					}
+					Message message { static_cast< unsigned int >(candidate.y * aSearch.width + candidate.x), current.index, current.actualCost + (candidate.diagonal ? DiagonalStepCost : 1.0) };
+					if (message.actualCost + aSearch.estimateCost( message.cell) >= aSearch.incumbent.load( std::memory_order_relaxed))
+					{
+						continue;
+					}
+					unsigned int owner = aSearch.ownerOf( message.cell);
+					if (owner == aWorker)
+					{
+						relax( message);
+						continue;
+					}
+					outboxes[owner].push_back( message);
+					if (outboxes[owner].size() >= BatchSize)
+					{
+						aSearch.send( owner, outboxes[owner]);
+					}
+				}
+			}
+			for (unsigned int owner = 0; owner < aSearch.workerCount; ++owner)
+			{
+				if (!outboxes[owner].empty())
+				{
+					aSearch.send( owner, outboxes[owner]);
+				}
+			}
+
+			if (hasWork())
+			{
+				// Lets the other workers catch up where they share a core: a worker that runs
+				// ahead alone expands cells that the routes it has not been sent yet improve on
+				std::this_thread::yield();
+				continue;
+			}
+			if (active)
+			{
+				aSearch.activity.fetch_sub( ActiveWorker);
+				active = false;
+			}
+			// Nobody busy and nothing underway: nothing can get any work anymore
+			if (aSearch.activity.load() == 0)
+			{
+				break;
+			}
+			std::this_thread::yield();
+		}
+		aSearch.expansionCount.fetch_add( expandedCount);
+	}
+} // namespace PathAlgorithm
@@ -0,0 +1,89 @@
+#ifndef PARALLELASTAR_HPP_
+#define PARALLELASTAR_HPP_
+
+#include "Config.hpp"
+
+#include <cstddef>
+#include <vector>
+
+#include "AStar.hpp"
+
+namespace PathAlgorithm
+{
+	/**
+	 * Hash Distributed A* (Kishimoto, Fukunaga and Botea): one long search spread over a number of
+	 * worker threads. Every cell is owned by one worker, chosen by a hash of the tile of
+	 * TileSize x TileSize cells it lies in, so most neighbours of a cell have the same owner.
+	 * Each worker has an openSet of its own and only expands and updates its own cells. A
+	 * neighbour that belongs to another worker is sent to that worker, in batches, through its
+	 * lock-free inbox.
+	 *
+	 * The workers prune everything that can not beat the cheapest route to the goal found so
+	 * far. The search has ended when no worker has a cell left below that cost and no batch is
+	 * underway; the workers keep both counts in one atomic word so they see both at once.
+	 *
+	 * The routes cost the same as those of AStar. The search is meant for long routes on large
+	 * worlds: every search starts its threads anew, no snapshots are published while the workers
+	 * run and only the expansions are counted in the stats. With less than two threads the
+	 * search is left to AStar.
+	 */
+	class ParallelAStar : public AStar
+	{
+		public:
+			/**
+			 * The cells of a tile have the same owner
+			 */
+			static const int TileSize = 8;
+			/**
+			 * The number of neighbours for one worker that are collected before they are sent
+			 */
+			static const std::size_t BatchSize = 64;
+			/**
+			 * aThreadCount is the number of workers, the caller included, 0 for one per core
+			 */
+			explicit ParallelAStar( unsigned int aThreadCount = 0);
+			using AStar::search;
+			/**
+			 *
+			 */
+			virtual Path search(Vertex aStart,
+								const Vertex& aGoal,
+								const Size& aRobotSize);
+			/**
+			 *
+			 */
+			virtual std::size_t getAllocatedBytes() const;
+			/**
+			 *
+			 */
+			unsigned int getThreadCount() const
+			{
+				return threadCount;
+			}
+			/**
+			 * Sets the number of workers of the next searches, 0 for one per core. A caller that
+			 * runs searches on several threads at once gives each a share of the cores.
+			 */
+			void setThreadCount( unsigned int aThreadCount);
+
+		private:
+			/**
+			 * The state the workers share
+			 */
+			struct Search;
+			/**
+			 * Runs aWorker until the search has ended or is cancelled
+			 */
+			void work(	Search& aSearch,
+						unsigned int aWorker) const;
+
+			unsigned int threadCount;
+			/**
+			 * Per cell the cost of the best route found and the cell it came from, a cell is only
+			 * written by its owner
+			 */
+			std::vector< double > actualCosts;
+			std::vector< unsigned int > parents;
+	}; // class ParallelAStar
+} // namespace PathAlgorithm
+#endif // PARALLELASTAR_HPP_
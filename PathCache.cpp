@@ -0,0 +1,210 @@
+#include "PathCache.hpp"
+#include <cmath>
+#include <tuple>
+
+namespace PathAlgorithm
+{
+	/**
+	 *
+	 */
+	bool PathCache::KeyLess::operator()(	const Key& lhs,
+											const Key& rhs) const
+	{
+		return std::tie( lhs.startX, lhs.startY, lhs.goalX, lhs.goalY, lhs.radius, lhs.wallRevision) <
+			   std::tie( rhs.startX, rhs.startY, rhs.goalX, rhs.goalY, rhs.radius, rhs.wallRevision);
+	}
+	/**
+	 *
+	 */
+	PathCache::PathCache() :
+								capacity( 64),
+								quantum( 4),
+								wallRevision( 0),
+								hits( 0),
+								misses( 0)
+	{
+	}
+	/**
+	 *
+	 */
+	/* static */ PathCache& PathCache::getPathCache()
+	{
+		static PathCache pathCache;
+		return pathCache;
+	}
+	/**
+	 *
+	 */
+	bool PathCache::find(	const Vertex& aStart,
+							const Vertex& aGoal,
+							const OccupancyGrid& anOccupancyGrid,
+							Path& aPath)
+	{
+		std::lock_guard< std::mutex > lock( cacheMutex);
+
+		synchronise( anOccupancyGrid.getWallRevision());
+
+		std::map< Key, Entries::iterator, KeyLess >::iterator i = index.find( makeKey( aStart, aGoal, anOccupancyGrid));
+		if (i == index.end())
+		{
+			++misses;
+			return false;
+		}
+		const Path& path = (*(*i).second).path;
+
+		// Walk in a straight line to the start of the cached route
+		Path connection( 1, Vertex( aStart.x, aStart.y));
+		Vertex current( aStart.x, aStart.y);
+		while (!current.equalPoint( path.front()))
+		{
+			current = Vertex( current.x + Sign( path.front().x - current.x), current.y + Sign( path.front().y - current.y));
+			if (!anOccupancyGrid.isFree( current.x, current.y))
+			{
+				++misses;
+				return false;
+			}
+			connection.push_back( current);
+		}
+
+		aPath.swap( connection);
+		aPath.insert( aPath.end(), path.begin() + 1, path.end());
+		for (std::size_t j = 1; j < aPath.size(); ++j)
+		{
+			aPath[j].actualCost = aPath[j - 1].actualCost + ActualCost( aPath[j - 1], aPath[j]);
+			aPath[j].heuristicCost = aPath[j].actualCost;
+		}
+
+		entries.splice( entries.begin(), entries, (*i).second);
+		++hits;
+		return true;
+	}
+	/**
+	 *
+	 */
+	void PathCache::insert(	const Vertex& aStart,
+							const Vertex& aGoal,
+							const OccupancyGrid& anOccupancyGrid,
+							const Path& aPath)
+	{
+		std::lock_guard< std::mutex > lock( cacheMutex);
+
+		synchronise( anOccupancyGrid.getWallRevision());
+		if (aPath.empty() || capacity == 0 || anOccupancyGrid.getWallRevision() != wallRevision)
+		{
+			return;
+		}
+
+		Key key = makeKey( aStart, aGoal, anOccupancyGrid);
+		std::map< Key, Entries::iterator, KeyLess >::iterator i = index.find( key);
+		if (i != index.end())
+		{
+			entries.erase( (*i).second);
+			index.erase( i);
+		}
+
+		entries.push_front( Entry { key, aPath });
+		index[key] = entries.begin();
+		while (entries.size() > capacity)
+		{
+			index.erase( entries.back().key);
+			entries.pop_back();
+		}
+	}
+	/**
+	 *
+	 */
+	void PathCache::clear()
+	{
+		std::lock_guard< std::mutex > lock( cacheMutex);
+		entries.clear();
+		index.clear();
+	}
+	/**
+	 *
+	 */
+	std::size_t PathCache::getCapacity() const
+	{
+		std::lock_guard< std::mutex > lock( cacheMutex);
+		return capacity;
+	}
+	/**
+	 *
+	 */
+	void PathCache::setCapacity( std::size_t aCapacity)
+	{
+		std::lock_guard< std::mutex > lock( cacheMutex);
+		capacity = aCapacity;
+		while (entries.size() > capacity)
+		{
+			index.erase( entries.back().key);
+			entries.pop_back();
+		}
+	}
+	/**
+	 *
+	 */
+	int PathCache::getQuantum() const
+	{
+		std::lock_guard< std::mutex > lock( cacheMutex);
+		return quantum;
+	}
+	/**
+	 *
+	 */
+	void PathCache::setQuantum( int aQuantum)
+	{
+		std::lock_guard< std::mutex > lock( cacheMutex);
+		quantum = aQuantum > 0 ? aQuantum : 1;
+		entries.clear();
+		index.clear();
+	}
+	/**
+	 *
+	 */
+	unsigned long PathCache::getHits() const
+	{
+		std::lock_guard< std::mutex > lock( cacheMutex);
+		return hits;
+	}
+	/**
+	 *
+	 */
+	unsigned long PathCache::getMisses() const
+	{
+		std::lock_guard< std::mutex > lock( cacheMutex);
+		return misses;
+	}
+	/**
+	 *
+	 */
+	std::size_t PathCache::size() const
+	{
+		std::lock_guard< std::mutex > lock( cacheMutex);
+		return entries.size();
+	}
+	/**
+	 *
+	 */
+	PathCache::Key PathCache::makeKey(	const Vertex& aStart,
+										const Vertex& aGoal,
+										const OccupancyGrid& anOccupancyGrid) const
+	{
+		// Floor division, so cells left of and above (0,0) get their own squares
+		int startX = aStart.x >= 0 ? aStart.x / quantum : (aStart.x - quantum + 1) / quantum;
+		int startY = aStart.y >= 0 ? aStart.y / quantum : (aStart.y - quantum + 1) / quantum;
+		return Key { startX, startY, aGoal.x, aGoal.y, anOccupancyGrid.getRadius(), anOccupancyGrid.getWallRevision() };
+	}
+	/**
+	 *
+	 */
+	void PathCache::synchronise( unsigned long aWallRevision)
+	{
+		// Only move forward, a search that started before the walls changed may still come back
+		if (aWallRevision > wallRevision)
+		{
+			entries.clear();
+			index.clear();
+			wallRevision = aWallRevision;
+		}
+	}
+} // namespace PathAlgorithm
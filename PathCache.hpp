@@ -0,0 +1,145 @@
+#ifndef PATHCACHE_HPP_
+#define PATHCACHE_HPP_
+
+#include "Config.hpp"
+
+#include <list>
+#include <map>
+#include <mutex>
+
+#include "AStar.hpp"
+#include "OccupancyGrid.hpp"
+
+namespace PathAlgorithm
+{
+	/**
+	 * A least recently used cache of the routes found by the planners, keyed by the start (rounded
+	 * to a square of getQuantum() cells), the goal, the free radius of the robot and the wall
+	 * revision of the RobotWorld. The key has no planner, so only the planners whose routes cost
+	 * the same as the AStar routes share the cache, see AStar::isCacheable.
+	 *
+	 * A route is only returned for the wall revision it was found in: as soon as the walls change
+	 * all routes are dropped. If the start differs from the start of the cached route, the robot
+	 * is first moved to that start in a straight line, provided that line is free.
+	 */
+	class PathCache
+	{
+		public:
+			/**
+			 *
+			 */
+			static PathCache& getPathCache();
+			/**
+			 * Looks up the route from aStart to aGoal for a robot with aRadius in the wall revision
+			 * of anOccupancyGrid
+			 *
+			 * @return true if a route was found, the route is returned in aPath
+			 */
+			bool find(	const Vertex& aStart,
+						const Vertex& aGoal,
+						const OccupancyGrid& anOccupancyGrid,
+						Path& aPath);
+			/**
+			 * Adds the route aPath, found in the wall revision of anOccupancyGrid, to the cache
+			 */
+			void insert(	const Vertex& aStart,
+							const Vertex& aGoal,
+							const OccupancyGrid& anOccupancyGrid,
+							const Path& aPath);
+			/**
+			 *
+			 */
+			void clear();
+			/**
+			 *
+			 */
+			std::size_t getCapacity() const;
+			/**
+			 * Evicts the least recently used routes if there are more than aCapacity
+			 */
+			void setCapacity( std::size_t aCapacity);
+			/**
+			 *
+			 */
+			int getQuantum() const;
+			/**
+			 * Clears the cache as the keys change
+			 */
+			void setQuantum( int aQuantum);
+			/**
+			 *
+			 */
+			unsigned long getHits() const;
+			/**
+			 *
+			 */
+			unsigned long getMisses() const;
+			/**
+			 *
+			 */
+			std::size_t size() const;
+
+		private:
+			/**
+			 *
+			 */
+			struct Key
+			{
+					int startX;
+					int startY;
+					int goalX;
+					int goalY;
+					int radius;
+					unsigned long wallRevision;
+			};
+			// struct Key
+			/**
+			 *
+			 */
+			struct KeyLess
+			{
+					bool operator()(	const Key& lhs,
+										const Key& rhs) const;
+			};
+			// struct KeyLess
+			/**
+			 *
+			 */
+			struct Entry
+			{
+					Key key;
+					Path path;
+			};
+			// struct Entry
+			typedef std::list< Entry > Entries;
+			/**
+			 *
+			 */
+			PathCache();
+			/**
+			 *
+			 */
+			Key makeKey(	const Vertex& aStart,
+							const Vertex& aGoal,
+							const OccupancyGrid& anOccupancyGrid) const;
+			/**
+			 * Drops all routes if the walls changed since the last call
+			 */
+			void synchronise( unsigned long aWallRevision);
+
+			std::size_t capacity;
+			int quantum;
+			unsigned long wallRevision;
+			unsigned long hits;
+			unsigned long misses;
+
+			/**
+			 * The most recently used entry first
+			 */
+			Entries entries;
+			std::map< Key, Entries::iterator, KeyLess > index;
+
+			mutable std::mutex cacheMutex;
+	}; // class PathCache
+} // namespace PathAlgorithm
+#endif // PATHCACHE_HPP_
@@ -0,0 +1,236 @@
+#include "PlanningService.hpp"
+#include "CooperativeAStar.hpp"
+#include "Goal.hpp"
+#include "ParallelAStar.hpp"
+#include <algorithm>
+#include <exception>
+#include <map>
+#include <utility>
+
+namespace Model
+{
+	namespace
+	{
+		/**
+		 *
+		 */
+		template< typename Task >
+		bool IsCancelled( const Task& aTask)
+		{
+			return aTask.cancellationToken && aTask.cancellationToken->isCancelled();
+		}
+	} // namespace
+
+	/**
+	 *
+	 */
+	/* static */ PlanningService& PlanningService::getPlanningService()
+	{
+		static PlanningService planningService( std::thread::hardware_concurrency());
+		return planningService;
+	}
+	/**
+	 *
+	 */
+	PlanningService::PlanningService( unsigned int aNumberOfWorkers) :
+								searchThreadCount( std::max( std::thread::hardware_concurrency() / std::max( aNumberOfWorkers, 1U), 1U)),
+								stopping( false)
+	{
+		for (unsigned int i = 0; i < std::max( aNumberOfWorkers, 1U); ++i)
+		{
+			workers.push_back( std::thread( [this]
+											{
+												work();
+											}));
+		}
+	}
+	/**
+	 *
+	 */
+	PlanningService::~PlanningService()
+	{
+		{
+			std::lock_guard< std::mutex > lock( tasksMutex);
+			stopping = true;
+		}
+		tasksAvailable.notify_all();
+		for (std::thread& worker : workers)
+		{
+			worker.join();
+		}
+	}
+	/**
+	 *
+	 */
+	std::vector< std::future< PathAlgorithm::Path > > PlanningService::plan( const std::vector< PlanningRequest >& aBatch)
+	{
+		std::vector< std::future< PathAlgorithm::Path > > routes;
+		routes.reserve( aBatch.size());
+
+		// One synchronisation of the grid per robot radius for the whole batch
+		std::map< int, PathAlgorithm::OccupancyGridPtr > occupancyGrids;
+
+		std::deque< Task > batch;
+		std::shared_ptr< std::vector< Task > > cooperativeTasks = std::make_shared< std::vector< Task > >();
+		for (const PlanningRequest& request : aBatch)
+		{
+			Task task;
+			task.robotName = request.robot->getName();
+			task.start = request.robot->getPosition();
+			task.goal = request.goal->getPosition();
+			task.robotSize = request.robot->getSize();
+			task.searchMode = request.robot->getSearchMode();
+			task.cancellationToken = request.cancellationToken;
+
+			int radius = PathAlgorithm::FreeRadius( task.robotSize);
+			PathAlgorithm::OccupancyGridPtr& occupancyGrid = occupancyGrids[radius];
+			if (!occupancyGrid)
+			{
+				occupancyGrid = PathAlgorithm::OccupancyGrid::getOccupancyGrid( radius);
+			}
+			task.occupancyGrid = occupancyGrid;
+
+			routes.push_back( task.route.get_future());
+			if (task.searchMode == Robot::CooperativeMode)
+			{
+				cooperativeTasks->push_back( std::move( task));
+			} else
+			{
+				batch.push_back( std::move( task));
+			}
+		}
+		if (!cooperativeTasks->empty())
+		{
+			Task task;
+			task.cooperativeTasks = cooperativeTasks;
+			batch.push_back( std::move( task));
+		}
+
+		{
+			std::lock_guard< std::mutex > lock( tasksMutex);
+			for (Task& task : batch)
+			{
+				tasks.push_back( std::move( task));
+			}
+		}
+		tasksAvailable.notify_all();
+
+		return routes;
+	}
+	/**
+	 *
+	 */
+	void PlanningService::work()
+	{
+		// The planners of this worker, with their own openSet and workspace
+		std::map< Robot::SearchMode, PathAlgorithm::AStarPtr > planners;
+
+		for (;;)
+		{
+			Task task;
+			{
+				std::unique_lock< std::mutex > lock( tasksMutex);
+				while (tasks.empty() && !stopping)
+				{
+					tasksAvailable.wait( lock);
+				}
+				if (tasks.empty())
+				{
+					return;
+				}
+				task = std::move( tasks.front());
+				tasks.pop_front();
+			}
+
+			if (task.cooperativeTasks)
+			{
+				planCooperatively( *task.cooperativeTasks);
+				continue;
+			}
+
+			PathAlgorithm::AStarPtr& planner = planners[task.searchMode];
+			try
+			{
+				if (IsCancelled( task))
+				{
+					throw PathAlgorithm::SearchCancelled();
+				}
+				if (!planner)
+				{
+					planner = Robot::createPlanner( task.searchMode);
+					if (std::shared_ptr< PathAlgorithm::ParallelAStar > parallelAStar = std::dynamic_pointer_cast< PathAlgorithm::ParallelAStar >( planner))
+					{
+						parallelAStar->setThreadCount( searchThreadCount);
+					}
+				}
+				planner->setCancellationToken( task.cancellationToken);
+				PathAlgorithm::SearchStats searchStats;
+				try
+				{
+					task.route.set_value( planner->search( task.start, task.goal, task.robotSize, task.occupancyGrid, searchStats));
+				}
+				catch (const PathAlgorithm::SearchCancelled&)
+				{
+					Robot::recordSearchStats( task.robotName, searchStats);
+					throw;
+				}
+				Robot::recordSearchStats( task.robotName, searchStats);
+			}
+			catch (...)
+			{
+				task.route.set_exception( std::current_exception());
+			}
+			if (planner)
+			{
+				planner->setCancellationToken( nullptr);
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	void PlanningService::planCooperatively( std::vector< Task >& aTasks)
+	{
+		PathAlgorithm::CooperativeAStar planner;
+		planner.setReservationTable( std::make_shared< PathAlgorithm::ReservationTable >());
+
+		std::vector< PathAlgorithm::Path > routes( aTasks.size());
+		std::vector< std::exception_ptr > exceptions( aTasks.size());
+		for (std::size_t i = 0; i < aTasks.size(); ++i)
+		{
+			// A cancelled robot does not drive, so its route is not reserved either
+			if (IsCancelled( aTasks[i]))
+			{
+				exceptions[i] = std::make_exception_ptr( PathAlgorithm::SearchCancelled());
+				continue;
+			}
+			PathAlgorithm::SearchStats searchStats;
+			try
+			{
+				planner.setCancellationToken( aTasks[i].cancellationToken);
+				routes[i] = planner.search( aTasks[i].start, aTasks[i].goal, aTasks[i].robotSize, aTasks[i].occupancyGrid, searchStats);
+				Robot::recordSearchStats( aTasks[i].robotName, searchStats);
+			}
+			catch (const PathAlgorithm::SearchCancelled&)
+			{
+				Robot::recordSearchStats( aTasks[i].robotName, searchStats);
+				exceptions[i] = std::current_exception();
+			}
+			catch (...)
+			{
+				exceptions[i] = std::current_exception();
+			}
+		}
+
+		for (std::size_t i = 0; i < aTasks.size(); ++i)
+		{
+			if (exceptions[i])
+			{
+				aTasks[i].route.set_exception( exceptions[i]);
+			} else
+			{
+				aTasks[i].route.set_value( routes[i]);
+			}
+		}
+	}
+} // namespace Model
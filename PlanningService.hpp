@@ -0,0 +1,135 @@
+#ifndef PLANNINGSERVICE_HPP_
+#define PLANNINGSERVICE_HPP_
+
+#include "Config.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AStar.hpp"
+#include "OccupancyGrid.hpp"
+#include "Robot.hpp"
+
+namespace Model
+{
+	/**
+	 * A route to plan: the route of aRobot from its current position to aGoal. The search is
+	 * cancelled through aCancellationToken, if given.
+	 */
+	struct PlanningRequest
+	{
+			PlanningRequest(	RobotPtr aRobot,
+								GoalPtr aGoal,
+								PathAlgorithm::CancellationTokenPtr aCancellationToken = nullptr) :
+									robot( aRobot),
+									goal( aGoal),
+									cancellationToken( aCancellationToken)
+			{
+			}
+
+			RobotPtr robot;
+			GoalPtr goal;
+			PathAlgorithm::CancellationTokenPtr cancellationToken;
+	};
+	// struct PlanningRequest
+
+	/**
+	 * Plans the routes of a batch of robots in parallel on a fixed pool of worker threads.
+	 *
+	 * Every worker has planners of its own, one per search mode, so the workers never share an
+	 * openSet or a workspace. The robots of a batch that plan cooperatively are planned by one
+	 * worker in the order of the batch, sharing a ReservationTable. The occupancy grids of a batch
+	 * are synchronised with the walls once, in plan, and every search of the batch is pinned to
+	 * the grid of its robot radius (see OccupancyGrid::Pin), so the workers never look at the
+	 * RobotWorld. A planner that needs a grid for an other radius thresholds it from the
+	 * DistanceField of the pinned grid. A ParallelAStar of a worker gets its share of the cores.
+	 *
+	 * The future of a request that was cancelled throws PathAlgorithm::SearchCancelled, a request
+	 * cancelled while queued is not searched at all.
+	 */
+	class PlanningService
+	{
+		public:
+			/**
+			 * The service with a worker per hardware thread
+			 */
+			static PlanningService& getPlanningService();
+			/**
+			 * Starts aNumberOfWorkers workers, at least 1
+			 */
+			explicit PlanningService( unsigned int aNumberOfWorkers);
+			/**
+			 * Finishes the requests that are queued and stops the workers
+			 */
+			~PlanningService();
+			/**
+			 * Queues aBatch, the positions, sizes and search modes of the robots are taken now
+			 *
+			 * @return the future routes, in the order of aBatch
+			 */
+			std::vector< std::future< PathAlgorithm::Path > > plan( const std::vector< PlanningRequest >& aBatch);
+			/**
+			 *
+			 */
+			unsigned int getNumberOfWorkers() const
+			{
+				return static_cast< unsigned int >(workers.size());
+			}
+
+		private:
+			/**
+			 *
+			 */
+			struct Task
+			{
+					std::string robotName;
+					Point start;
+					Point goal;
+					Size robotSize;
+					Robot::SearchMode searchMode;
+					/**
+					 * The grid of the batch for the radius of the robot, the route is searched in it
+					 */
+					PathAlgorithm::OccupancyGridPtr occupancyGrid;
+					std::promise< PathAlgorithm::Path > route;
+					PathAlgorithm::CancellationTokenPtr cancellationToken;
+					/**
+					 * The CooperativeMode tasks of a batch are queued as one task, see
+					 * planCooperatively
+					 */
+					std::shared_ptr< std::vector< Task > > cooperativeTasks;
+			};
+			// struct Task
+			/**
+			 * The loop of a worker thread
+			 */
+			void work();
+			/**
+			 * Plans the routes of aTasks one after the other around the routes planned before them,
+			 * the first task has the highest priority. The routes are handed out together as the
+			 * reservations count on the robots starting at the same time.
+			 */
+			void planCooperatively( std::vector< Task >& aTasks);
+
+			PlanningService( const PlanningService&) = delete;
+			PlanningService& operator=( const PlanningService&) = delete;
+
+			std::vector< std::thread > workers;
+			/**
+			 * The threads of a ParallelAStar search of a worker: the workers search at the same
+			 * time, with a thread per core each they would start workers times cores threads
+			 */
+			unsigned int searchThreadCount;
+			std::deque< Task > tasks;
+			bool stopping;
+			std::mutex tasksMutex;
+			std::condition_variable tasksAvailable;
+	}; // class PlanningService
+} // namespace Model
+#endif // PLANNINGSERVICE_HPP_
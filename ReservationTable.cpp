@@ -0,0 +1,156 @@
+#include "ReservationTable.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace PathAlgorithm
+{
+	/* static */ const int ReservationTable::DefaultCellSize;
+	/**
+	 *
+	 */
+	ReservationTable::ReservationTable( int aCellSize /* = DefaultCellSize */) :
+								cellSize( std::max( aCellSize, 1)),
+								maximumRadius( 0),
+								lastTick( 0),
+								reservationCount( 0)
+	{
+	}
+	/**
+	 *
+	 */
+	void ReservationTable::reserve(	const Path& aRoute,
+									int aRadius)
+	{
+		if (aRoute.empty())
+		{
+			return;
+		}
+		maximumRadius = std::max( maximumRadius, aRadius);
+
+		// The position at every whole tick, rounded as Robot::drive does
+		unsigned int tick = 0;
+		double start = 0.0;
+		for (std::size_t i = 1; i < aRoute.size(); ++i)
+		{
+			double duration = Duration( aRoute[i - 1], aRoute[i]);
+			for (; tick < start + duration; ++tick)
+			{
+				double fraction = (tick - start) / duration;
+				add( Reservation { aRoute[i - 1].x + static_cast< int >(std::round( (aRoute[i].x - aRoute[i - 1].x) * fraction)),
+								   aRoute[i - 1].y + static_cast< int >(std::round( (aRoute[i].y - aRoute[i - 1].y) * fraction)),
+								   aRadius },
+					 tick);
+			}
+			start += duration;
+		}
+		parked.push_back( Parked { Reservation { aRoute.back().x, aRoute.back().y, aRadius }, tick });
+		lastTick = std::max( lastTick, tick);
+	}
+	/**
+	 *
+	 */
+	bool ReservationTable::isFree(	int anX,
+									int anY,
+									int aRadius,
+									unsigned int aTick) const
+	{
+		for (const Parked& robot : parked)
+		{
+			long dX = robot.reservation.x - anX;
+			long dY = robot.reservation.y - anY;
+			long distance = robot.reservation.radius + aRadius;
+			if (aTick >= robot.tick && dX * dX + dY * dY < distance * distance)
+			{
+				return false;
+			}
+		}
+
+		// Any disc that overlaps has its centre within the radii of (anX,anY)
+		int reach = aRadius + maximumRadius;
+		for (int cellY = cellOf( anY - reach); cellY <= cellOf( anY + reach); ++cellY)
+		{
+			for (int cellX = cellOf( anX - reach); cellX <= cellOf( anX + reach); ++cellX)
+			{
+				std::unordered_map< std::uint64_t, std::vector< Reservation > >::const_iterator slot = slots.find( slotOf( cellX, cellY, aTick));
+				if (slot == slots.end())
+				{
+					continue;
+				}
+				for (const Reservation& reservation : slot->second)
+				{
+					long dX = reservation.x - anX;
+					long dY = reservation.y - anY;
+					long distance = reservation.radius + aRadius;
+					if (dX * dX + dY * dY < distance * distance)
+					{
+						return false;
+					}
+				}
+			}
+		}
+		return true;
+	}
+	/**
+	 *
+	 */
+	bool ReservationTable::isFreeFrom(	int anX,
+										int anY,
+										int aRadius,
+										unsigned int aTick) const
+	{
+		// After the last tick only the parked robots remain, which isFree checks at every tick
+		for (unsigned int tick = aTick; tick <= std::max( aTick, lastTick); ++tick)
+		{
+			if (!isFree( anX, anY, aRadius, tick))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+	/**
+	 *
+	 */
+	void ReservationTable::clear()
+	{
+		slots.clear();
+		parked.clear();
+		maximumRadius = 0;
+		lastTick = 0;
+		reservationCount = 0;
+	}
+	/**
+	 *
+	 */
+	/* static */ double ReservationTable::Duration(	const Vertex& aFrom,
+													const Vertex& aTo)
+	{
+		return std::max( ActualCost( aFrom, aTo), 1.0);
+	}
+	/**
+	 *
+	 */
+	std::uint64_t ReservationTable::slotOf(	int aCellX,
+											int aCellY,
+											unsigned int aTick) const
+	{
+		return (static_cast< std::uint64_t >(static_cast< std::uint16_t >(aCellX)) << 48) | (static_cast< std::uint64_t >(static_cast< std::uint16_t >(aCellY)) << 32) | aTick;
+	}
+	/**
+	 *
+	 */
+	int ReservationTable::cellOf( int aCoordinate) const
+	{
+		// Rounded down, also for the cells left of and above the world
+		return aCoordinate >= 0 ? aCoordinate / cellSize : -((-aCoordinate + cellSize - 1) / cellSize);
+	}
+	/**
+	 *
+	 */
+	void ReservationTable::add(	const Reservation& aReservation,
+								unsigned int aTick)
+	{
+		slots[slotOf( cellOf( aReservation.x), cellOf( aReservation.y), aTick)].push_back( aReservation);
+		++reservationCount;
+	}
+} // namespace PathAlgorithm
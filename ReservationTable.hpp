@@ -0,0 +1,122 @@
+#ifndef RESERVATIONTABLE_HPP_
+#define RESERVATIONTABLE_HPP_
+
+#include "Config.hpp"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "AStar.hpp"
+
+namespace PathAlgorithm
+{
+	/**
+	 * The space-time slots taken by the routes of the robots that were planned before: for every
+	 * tick the disc a robot covers, filed under the coarse (cell, tick) slot of its centre. A robot
+	 * stays on the last vertex of its route forever after.
+	 *
+	 * A tick is the time a robot needs for one straight step, a diagonal step takes sqrt(2) ticks
+	 * and a wait, a vertex repeated in the route, one tick. All robots of a table are assumed to
+	 * start at tick 0 and to drive at the same speed.
+	 */
+	class ReservationTable
+	{
+		public:
+			/**
+			 * The size of the coarse cells of the slots
+			 */
+			static const int DefaultCellSize = 16;
+			/**
+			 *
+			 */
+			explicit ReservationTable( int aCellSize = DefaultCellSize);
+			/**
+			 * Reserves the discs with aRadius along aRoute
+			 */
+			void reserve(	const Path& aRoute,
+							int aRadius);
+			/**
+			 * @return true if a robot with aRadius on (anX,anY) at aTick overlaps no reserved disc
+			 */
+			bool isFree(	int anX,
+							int anY,
+							int aRadius,
+							unsigned int aTick) const;
+			/**
+			 * @return true if a robot with aRadius may stay on (anX,anY) from aTick on
+			 */
+			bool isFreeFrom(	int anX,
+								int anY,
+								int aRadius,
+								unsigned int aTick) const;
+			/**
+			 *
+			 */
+			void clear();
+			/**
+			 * @return the tick after which only the robots that stay on their goal are reserved
+			 */
+			unsigned int getLastTick() const
+			{
+				return lastTick;
+			}
+			/**
+			 * @return the number of reserved discs
+			 */
+			std::size_t size() const
+			{
+				return reservationCount;
+			}
+			/**
+			 * @return the time a robot needs from aFrom to aTo, a wait takes one tick
+			 */
+			static double Duration(	const Vertex& aFrom,
+									const Vertex& aTo);
+
+		private:
+			/**
+			 *
+			 */
+			struct Reservation
+			{
+					int x;
+					int y;
+					int radius;
+			};
+			// struct Reservation
+			/**
+			 * A robot that stays on its goal from a tick on
+			 */
+			struct Parked
+			{
+					Reservation reservation;
+					unsigned int tick;
+			};
+			// struct Parked
+			/**
+			 *
+			 */
+			std::uint64_t slotOf(	int aCellX,
+									int aCellY,
+									unsigned int aTick) const;
+			/**
+			 *
+			 */
+			int cellOf( int aCoordinate) const;
+			/**
+			 *
+			 */
+			void add(	const Reservation& aReservation,
+						unsigned int aTick);
+
+			int cellSize;
+			int maximumRadius;
+			unsigned int lastTick;
+			std::size_t reservationCount;
+
+			std::unordered_map< std::uint64_t, std::vector< Reservation > > slots;
+			std::vector< Parked > parked;
+	}; // class ReservationTable
+} // namespace PathAlgorithm
+#endif // RESERVATIONTABLE_HPP_
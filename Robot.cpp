@@ -3,6 +3,8 @@
 #include <ctime>
 #include <chrono>
 #include <algorithm>.
+#include <cmath>
+#include <exception>
 
 #include "Thread.hpp"
 #include "MathUtils.hpp"
@@ -17,6 +19,20 @@
 #include "Message.hpp"
 #include "MainApplication.hpp"
 #include "LaserDistanceSensor.hpp"
+#include "JumpPointSearch.hpp"
+#include "HierarchicalAStar.hpp"
+#include "FixedPointAStar.hpp"
+#include "AnytimeAStar.hpp"
+#include "ThetaStar.hpp"
+#include "DistanceField.hpp"
+#include "FlowField.hpp"
+#include "CooperativeAStar.hpp"
+#include "VisibilityGraph.hpp"
+#include "Landmarks.hpp"
+#include "StateLattice.hpp"
+#include "ParallelAStar.hpp"
+#include "AdaptiveAStar.hpp"
+#include "BidirectionalAStar.hpp"
 
 namespace Model
 {
@@ -28,12 +44,15 @@ Robot::Robot() : name(""),
 				 position(DefaultPosition),
 				 front(0, 0),
 				 speed(0.0),
+				 searchMode(AStarMode),
+				 replanner(new PathAlgorithm::DStarLite),
 				 acting(false),
 				 driving(false),
 				 communicating(false)
 {
 	std::shared_ptr<AbstractSensor> laserSensor(new LaserDistanceSensor(this));
 	attachSensor(laserSensor);
+	selectPlanner(defaultSearchMode());
 }
 /**
 	 *
@@ -43,12 +62,15 @@ Robot::Robot(const std::string &aName) : name(aName),
 										 position(DefaultPosition),
 										 front(0, 0),
 										 speed(0.0),
+										 searchMode(AStarMode),
+										 replanner(new PathAlgorithm::DStarLite),
 										 acting(false),
 										 driving(false),
 										 communicating(false)
 {
 	std::shared_ptr<AbstractSensor> laserSensor(new LaserDistanceSensor(this));
 	attachSensor(laserSensor);
+	selectPlanner(defaultSearchMode());
 }
 /**
 	 *
@@ -59,12 +81,15 @@ Robot::Robot(const std::string &aName,
 									   position(aPosition),
 									   front(0, 0),
 									   speed(0.0),
+									   searchMode(AStarMode),
+									   replanner(new PathAlgorithm::DStarLite),
 									   acting(false),
 									   driving(false),
 									   communicating(false)
 {
 	std::shared_ptr<AbstractSensor> laserSensor(new LaserDistanceSensor(this));
 	attachSensor(laserSensor);
+	selectPlanner(defaultSearchMode());
 }
 /**
 	 *
@@ -83,6 +108,9 @@ Robot::~Robot()
 	{
 		stopCommunicating();
 	}
+	// A route request that is still searching uses the planners of this robot
+	cancelRouteRequest();
+	std::lock_guard<std::mutex> lock(searchMutex);
 }
 /**
 	 *
@@ -155,6 +183,165 @@ void Robot::setPosition(const Point &aPosition,
 		notifyObservers();
 	}
 }
+/**
+	 *
+	 */
+void Robot::setSearchMode(SearchMode aSearchMode)
+{
+	// The search of a route request uses the planner until it is done
+	std::lock_guard<std::mutex> lock(searchMutex);
+	selectPlanner(aSearchMode);
+}
+/**
+	 *
+	 */
+/* static */ PathAlgorithm::AStarPtr Robot::createPlanner(SearchMode aSearchMode)
+{
+	switch (aSearchMode)
+	{
+	case JumpPointSearchMode:
+	{
+		return PathAlgorithm::AStarPtr(new PathAlgorithm::JumpPointSearch);
+	}
+	case DStarLiteMode:
+	{
+		return PathAlgorithm::AStarPtr(new PathAlgorithm::DStarLite);
+	}
+	case HierarchicalAStarMode:
+	{
+		return PathAlgorithm::AStarPtr(new PathAlgorithm::HierarchicalAStar);
+	}
+	case OctileAStarMode:
+	{
+		return PathAlgorithm::AStarPtr(new PathAlgorithm::OctileAStar);
+	}
+	case AnytimeAStarMode:
+	{
+		return PathAlgorithm::AStarPtr(new PathAlgorithm::AnytimeAStar);
+	}
+	case ThetaStarMode:
+	{
+		return PathAlgorithm::AStarPtr(new PathAlgorithm::ThetaStar);
+	}
+	case FlowFieldMode:
+	{
+		return PathAlgorithm::AStarPtr(new PathAlgorithm::FlowFieldSearch);
+	}
+	case CooperativeMode:
+	{
+		return PathAlgorithm::AStarPtr(new PathAlgorithm::CooperativeAStar);
+	}
+	case VisibilityGraphMode:
+	{
+		return PathAlgorithm::AStarPtr(new PathAlgorithm::VisibilityGraphSearch);
+	}
+	case LandmarkMode:
+	{
+		return PathAlgorithm::AStarPtr(new PathAlgorithm::LandmarkAStar);
+	}
+	case LatticeMode:
+	{
+		return PathAlgorithm::AStarPtr(new PathAlgorithm::StateLattice);
+	}
+	case ParallelMode:
+	{
+		return PathAlgorithm::AStarPtr(new PathAlgorithm::ParallelAStar);
+	}
+	case AdaptiveMode:
+	{
+		return PathAlgorithm::AStarPtr(new PathAlgorithm::AdaptiveAStar);
+	}
+	case BidirectionalMode:
+	{
+		return PathAlgorithm::AStarPtr(new PathAlgorithm::BidirectionalAStar);
+	}
+	case AStarMode:
+	default:
+	{
+		return PathAlgorithm::AStarPtr(new PathAlgorithm::AStar);
+	}
+	}
+}
+/**
+	 *
+	 */
+/* static */ void Robot::recordSearchStats(const std::string &aRobotName, const PathAlgorithm::SearchStats &aSearchStats)
+{
+	PathAlgorithm::SearchStatistics::getSearchStatistics().record(aRobotName, aSearchStats);
+	if (Application::MainApplication::isArgGiven("-search_stats"))
+	{
+		std::ostringstream os;
+		os << aRobotName << ": " << aSearchStats;
+		Application::Logger::log(os.str());
+	}
+}
+/**
+	 *
+	 */
+/* static */ Robot::SearchMode Robot::defaultSearchMode()
+{
+	if (Application::MainApplication::isArgGiven("-search_mode"))
+	{
+		std::string mode = Application::MainApplication::getArg("-search_mode").value;
+		if (mode == "jps")
+		{
+			return JumpPointSearchMode;
+		}
+		if (mode == "dstar")
+		{
+			return DStarLiteMode;
+		}
+		if (mode == "hpa")
+		{
+			return HierarchicalAStarMode;
+		}
+		if (mode == "octile")
+		{
+			return OctileAStarMode;
+		}
+		if (mode == "anytime")
+		{
+			return AnytimeAStarMode;
+		}
+		if (mode == "theta")
+		{
+			return ThetaStarMode;
+		}
+		if (mode == "flow")
+		{
+			return FlowFieldMode;
+		}
+		if (mode == "cooperative")
+		{
+			return CooperativeMode;
+		}
+		if (mode == "visibility")
+		{
+			return VisibilityGraphMode;
+		}
+		if (mode == "alt")
+		{
+			return LandmarkMode;
+		}
+		if (mode == "lattice")
+		{
+			return LatticeMode;
+		}
+		if (mode == "hda")
+		{
+			return ParallelMode;
+		}
+		if (mode == "adaptive")
+		{
+			return AdaptiveMode;
+		}
+		if (mode == "bidirectional")
+		{
+			return BidirectionalMode;
+		}
+	}
+	return AStarMode;
+}
 /**
 	 *
 	 */
@@ -202,6 +389,14 @@ void Robot::startActing()
 	std::thread newRobotThread([this] { startDriving(); });
 	robotThread.swap(newRobotThread);
 }
+/**
+	 *
+	 */
+void Robot::startActing(std::future<PathAlgorithm::Path> aRoute)
+{
+	plannedRoute = std::move(aRoute);
+	startActing();
+}
 /**
 	 *
 	 */
@@ -209,8 +404,48 @@ void Robot::stopActing()
 {
 	acting = false;
 	driving = false;
+	// The search the robot thread may be waiting for ends at its next expansion
+	cancelRouteRequest();
 	robotThread.join();
 }
+/**
+	 *
+	 */
+std::future<PathAlgorithm::Path> Robot::requestRoute(GoalPtr aGoal)
+{
+	return request(aGoal, false);
+}
+/**
+	 *
+	 */
+std::future<PathAlgorithm::Path> Robot::requestReroute(GoalPtr aGoal)
+{
+	return request(aGoal, true);
+}
+/**
+	 *
+	 */
+void Robot::cancelRouteRequest()
+{
+	std::lock_guard<std::mutex> lock(routeRequestMutex);
+	if (routeRequest)
+	{
+		routeRequest->cancel();
+	}
+}
+/**
+	 *
+	 */
+PathAlgorithm::CancellationTokenPtr Robot::newRouteRequest()
+{
+	std::lock_guard<std::mutex> lock(routeRequestMutex);
+	if (routeRequest)
+	{
+		routeRequest->cancel();
+	}
+	routeRequest = std::make_shared<PathAlgorithm::CancellationToken>();
+	return routeRequest;
+}
 /**
 	 *
 	 */
@@ -220,7 +455,31 @@ void Robot::startDriving()
 
 	goal = RobotWorld::getRobotWorld().getGoal(this->name);
 
-	calculateRoute(goal);
+	if (plannedRoute.valid())
+	{
+		// Planned by the PlanningService together with the routes of the other robots
+		front = BoundedVector(goal->getPosition(), position);
+		try
+		{
+			path = PathAlgorithm::CompactPath(plannedRoute.get());
+		}
+		catch (const PathAlgorithm::SearchCancelled &)
+		{
+			// Stopped, or the goal was moved while planning
+			if (acting)
+			{
+				calculateRoute(goal);
+			}
+		}
+		catch (const std::exception &e)
+		{
+			routeFailed(e);
+		}
+	}
+	else
+	{
+		calculateRoute(goal);
+	}
 
 	drive(goal);
 }
@@ -362,13 +621,8 @@ Point Robot::getBackRight() const
 	 */
 void Robot::handleNotification()
 {
-	//	std::unique_lock<std::recursive_mutex> lock(robotMutex);
-
-	static int update = 0;
-	if ((++update % 200) == 0)
-	{
-		notifyObservers();
-	}
+	// The planner only notifies when it published a new snapshot of its search
+	notifyObservers();
 }
 /**
 	 *
@@ -504,14 +758,33 @@ void Robot::drive(WayPointPtr aGoal)
 		auto myRobot = robots[0];
 		auto otherRobot = robots[1];
 
-		unsigned pathPoint = 0;
-		while (position.x > 0 && position.x < 500 && position.y > 0 && position.y < 500 && pathPoint < path.size())
+		// The route is walked by distance, the segments between its vertices can be of any length
+		// The vertices are expanded from the compact path one at a time
+		// A vertex repeated by a cooperative route is a wait as long as a straight step, the
+		// reservations of the other robots count on it
+		PathAlgorithm::CompactPath::const_iterator vertex = path.begin();
+		double travelled = 0.0;
+		while (position.x > 0 && position.x < 500 && position.y > 0 && position.y < 500 && path.end() - vertex > 1)
 		{
-			
-			const PathAlgorithm::Vertex &vertex = path[pathPoint += static_cast<int>(speed)];
-			front = BoundedVector(vertex.asPoint(), position);
-			position.x = vertex.x;
-			position.y = vertex.y;
+			double distance = speed;
+			while (path.end() - vertex > 1 && travelled + distance >= PathAlgorithm::ReservationTable::Duration(*vertex, vertex[1]))
+			{
+				distance -= PathAlgorithm::ReservationTable::Duration(*vertex, vertex[1]) - travelled;
+				travelled = 0.0;
+				++vertex;
+			}
+
+			Point next = (*vertex).asPoint();
+			if (path.end() - vertex > 1)
+			{
+				PathAlgorithm::Vertex to = vertex[1];
+				travelled += distance;
+				double fraction = travelled / PathAlgorithm::ReservationTable::Duration(*vertex, to);
+				next.x += static_cast<int>(std::round((to.x - next.x) * fraction));
+				next.y += static_cast<int>(std::round((to.y - next.y) * fraction));
+			}
+			front = BoundedVector(next, position);
+			position = next;
 			if (arrived(aGoal))
 			{
 				Application::Logger::log(__PRETTY_FUNCTION__ + std::string(": arrived"));
@@ -542,7 +815,7 @@ void Robot::drive(WayPointPtr aGoal)
 
 				if (this->getStop() == false )
 				{
-					calculateRoute(goal);
+					recalculateRoute(goal);
 					//	recalculatedNewPath = true;
 					driving = true;
 					drive(goal);
@@ -699,16 +972,153 @@ void Robot::calculateRoute(GoalPtr aGoal)
 	path.clear();
 	if (aGoal)
 	{
-		// Turn off logging if not debugging AStar
-		Application::Logger::setDisable();
-
+		Point goalPosition;
+		do
+		{
+			goalPosition = aGoal->getPosition();
+			front = BoundedVector(goalPosition, position);
+			try
+			{
+				path = PathAlgorithm::CompactPath(requestRoute(aGoal).get());
+			}
+			catch (const PathAlgorithm::SearchCancelled &)
+			{
+				// Stopped, or superseded by a newer request
+			}
+			catch (const std::exception &e)
+			{
+				routeFailed(e);
+				break;
+			}
+		}
+		// A goal that was moved while searching is searched again
+		while (path.empty() && acting && aGoal->getPosition() != goalPosition);
+	}
+}
+/**
+	 *
+	 */
+void Robot::recalculateRoute(GoalPtr aGoal)
+{
+	path.clear();
+	if (aGoal)
+	{
 		front = BoundedVector(aGoal->getPosition(), position);
-		handleNotificationsFor(astar);
-		path = astar.search(position, aGoal->getPosition(), size);
-		stopHandlingNotificationsFor(astar);
+		try
+		{
+			path = PathAlgorithm::CompactPath(requestReroute(aGoal).get());
+		}
+		catch (const PathAlgorithm::SearchCancelled &)
+		{
+			// Stopped, or superseded by a newer request
+		}
+		catch (const std::exception &e)
+		{
+			routeFailed(e);
+		}
+	}
+}
+/**
+	 *
+	 */
+std::future<PathAlgorithm::Path> Robot::request(GoalPtr aGoal,
+												bool aReroute)
+{
+	PathAlgorithm::CancellationTokenPtr token = newRouteRequest();
+	Point start = position;
+	Point goalPosition = aGoal->getPosition();
+	return std::async(std::launch::async, [this, token, start, goalPosition, aReroute] { return searchRoute(token, start, goalPosition, aReroute); });
+}
+/**
+	 *
+	 */
+PathAlgorithm::Path Robot::searchRoute(PathAlgorithm::CancellationTokenPtr aToken,
+									   const Point &aStart,
+									   const Point &aGoal,
+									   bool aReroute)
+{
+	// The search of the previous request was cancelled and ends at its next expansion
+	std::lock_guard<std::mutex> lock(searchMutex);
+	if (aToken->isCancelled())
+	{
+		throw PathAlgorithm::SearchCancelled();
+	}
 
-		Application::Logger::setDisable(false);
+	PathAlgorithm::AStarPtr currentPlanner = aReroute ? replanner : planner;
+	// The other robots are only avoided after a collision
+	replanner->clearBlockedAreas();
+	if (aReroute)
+	{
+		blockOtherRobots(aStart);
 	}
+
+	currentPlanner->setCancellationToken(aToken);
+	handleNotificationsFor(*currentPlanner);
+	PathAlgorithm::Path route;
+	std::exception_ptr exception;
+	try
+	{
+		route = currentPlanner->search(aStart, aGoal, size);
+	}
+	catch (...)
+	{
+		exception = std::current_exception();
+	}
+	stopHandlingNotificationsFor(*currentPlanner);
+	currentPlanner->setCancellationToken(nullptr);
+
+	recordSearchStats(name, currentPlanner->getStats());
+	if (exception)
+	{
+		std::rethrow_exception(exception);
+	}
+	return route;
+}
+/**
+	 *
+	 */
+void Robot::blockOtherRobots(const Point &aPosition)
+{
+	for (RobotPtr robot : RobotWorld::getRobotWorld().getRobots())
+	{
+		if (robot.get() == this)
+		{
+			continue;
+		}
+		// The footprint of the other robot in the configuration space of this robot, but
+		// this robot must be able to get away from where it is now
+		Point otherPosition = robot->getPosition();
+		double distance = std::sqrt(static_cast<double>((aPosition.x - otherPosition.x) * (aPosition.x - otherPosition.x) +
+														 (aPosition.y - otherPosition.y) * (aPosition.y - otherPosition.y)));
+		int radius = PathAlgorithm::FreeRadius(robot->getSize()) + PathAlgorithm::FreeRadius(size);
+		replanner->addBlockedArea(otherPosition, std::min(radius, static_cast<int>(distance)));
+	}
+}
+/**
+	 *
+	 */
+void Robot::selectPlanner(SearchMode aSearchMode)
+{
+	if (aSearchMode == DStarLiteMode)
+	{
+		// The initial route prepares the replanner for the replans after a collision
+		std::atomic_store(&planner, PathAlgorithm::AStarPtr(replanner));
+	}
+	else
+	{
+		std::atomic_store(&planner, createPlanner(aSearchMode));
+	}
+	searchMode = aSearchMode;
+}
+/**
+	 *
+	 */
+void Robot::routeFailed(const std::exception &anException)
+{
+	Application::Logger::log(__PRETTY_FUNCTION__ + std::string(": no route: ") + anException.what());
+	path.clear();
+	driving = false;
+	notifyObservers();
 }
 /**
 	 *
@@ -735,17 +1145,11 @@ bool Robot::collision_walls()
 	Point backLeft = getBackLeft();
 	Point backRight = getBackRight();
 
-	const std::vector<WallPtr> &walls = RobotWorld::getRobotWorld().getWalls();
-	for (WallPtr wall : walls)
-	{
-		if (Utils::Shape2DUtils::intersect(frontLeft, frontRight, wall->getPoint1(), wall->getPoint2()) ||
-			Utils::Shape2DUtils::intersect(frontLeft, backLeft, wall->getPoint1(), wall->getPoint2()) ||
-			Utils::Shape2DUtils::intersect(frontRight, backRight, wall->getPoint1(), wall->getPoint2()))
-		{
-			return true;
-		}
-	}
-	return false;
+	// The distance field skips the intersection tests with the walls far from the robot
+	PathAlgorithm::DistanceFieldPtr distanceField = PathAlgorithm::DistanceField::getDistanceField();
+	return distanceField->intersectsWall(frontLeft, frontRight) ||
+		   distanceField->intersectsWall(frontLeft, backLeft) ||
+		   distanceField->intersectsWall(frontRight, backRight);
 }
 bool Robot::collision_robot(std::vector<Model::RobotPtr> allRobots)
 {
@@ -3,6 +3,8 @@
 
 #include "Config.hpp"
 
+#include <atomic>
+#include <future>
 #include <iostream>
 #include <memory>
 #include <mutex>
@@ -12,6 +14,7 @@
 #include "AbstractAgent.hpp"
 #include "AStar.hpp"
 #include "BoundedVector.hpp"
+#include "DStarLite.hpp"
 #include "Message.hpp"
 #include "MessageHandler.hpp"
 #include "Observer.hpp"
@@ -135,9 +138,36 @@ namespace Model
 			 */
 		virtual void startActing();
 		/**
-			 *
+			 * Starts acting on aRoute instead of calculating the route when the robot starts driving
+			 */
+		void startActing(std::future<PathAlgorithm::Path> aRoute);
+		/**
+			 * Stops driving and cancels the route request the robot is waiting for
 			 */
 		virtual void stopActing();
+		/**
+			 * Searches the route from the current position to aGoal on a thread of its own, with the
+			 * planner of the search mode. The request that was searching before is cancelled, the
+			 * future of a cancelled request throws PathAlgorithm::SearchCancelled.
+			 *
+			 * The future must not outlive the robot.
+			 */
+		std::future<PathAlgorithm::Path> requestRoute(GoalPtr aGoal);
+		/**
+			 * As requestRoute, but the route is searched by the replanner around the other robots
+			 */
+		std::future<PathAlgorithm::Path> requestReroute(GoalPtr aGoal);
+		/**
+			 * Cancels the route request that is searching, if any
+			 */
+		void cancelRouteRequest();
+		/**
+			 * Cancels the route request that is searching, if any, and starts a new one
+			 *
+			 * @return the token of the new request, for a route that is searched elsewhere, see
+			 * PlanningRequest
+			 */
+		PathAlgorithm::CancellationTokenPtr newRouteRequest();
 		/**
 			 *
 			 * @return true if the robot is driving
@@ -211,17 +241,62 @@ namespace Model
 			 */
 		virtual void handleNotification();
 		//@}
+		/**
+			 * The search algorithms a Robot can use to calculate its route
+			 */
+		enum SearchMode
+		{
+			AStarMode,
+			JumpPointSearchMode,
+			DStarLiteMode,
+			HierarchicalAStarMode,
+			OctileAStarMode,
+			AnytimeAStarMode,
+			ThetaStarMode,
+			FlowFieldMode,
+			CooperativeMode,
+			VisibilityGraphMode,
+			LandmarkMode,
+			LatticeMode,
+			ParallelMode,
+			AdaptiveMode,
+			BidirectionalMode
+		};
 		/**
 			 *
 			 */
-		PathAlgorithm::OpenSet getOpenSet() const
+		SearchMode getSearchMode() const
 		{
-			return astar.getOpenSet();
+			return searchMode;
 		}
+		/**
+			 * Switches the robot to a new planner for aSearchMode, after the route request that is
+			 * searching, if any, is done. The default is AStarMode, unless given an other mode by
+			 * specifying a command line argument
+			 * -search_mode=astar|jps|dstar|hpa|octile|anytime|theta|flow|cooperative|visibility|alt|lattice|hda|adaptive|bidirectional
+			 */
+		void setSearchMode(SearchMode aSearchMode);
+		/**
+			 * @return a new planner for aSearchMode with a search state of its own
+			 */
+		static PathAlgorithm::AStarPtr createPlanner(SearchMode aSearchMode);
+		/**
+			 * Adds the costs of a route of aRobotName to the SearchStatistics, they are logged as well if
+			 * the command line argument -search_stats is given
+			 */
+		static void recordSearchStats(const std::string &aRobotName, const PathAlgorithm::SearchStats &aSearchStats);
 		/**
 			 *
 			 */
-		PathAlgorithm::Path getPath() const
+		PathAlgorithm::SearchSnapshotPtr getSearchSnapshot() const
+		{
+			// The planner may be switched by setSearchMode while the snapshot is taken
+			return std::atomic_load(&planner)->getSnapshot();
+		}
+		/**
+			 *
+			 */
+		PathAlgorithm::CompactPath getPath() const
 		{
 			return path;
 		}
@@ -306,6 +381,12 @@ namespace Model
 			 *
 			 */
 		void calculateRoute(GoalPtr aGoal);
+		/**
+			 * Calculates a new route around the other robots. The replanner keeps its search state
+			 * between calls, so only the part of the route that is affected by the other robots and
+			 * the walls that changed since the previous call is searched again.
+			 */
+		void recalculateRoute(GoalPtr aGoal);
 		/**
 			 *
 			 */
@@ -331,8 +412,20 @@ namespace Model
 		float speed;
 
 		GoalPtr goal;
-		PathAlgorithm::AStar astar;
-		PathAlgorithm::Path path;
+		std::atomic<SearchMode> searchMode;
+		/**
+			 * Replaced under the searchMutex, read atomically by getSearchSnapshot
+			 */
+		PathAlgorithm::AStarPtr planner;
+		PathAlgorithm::DStarLitePtr replanner;
+		PathAlgorithm::CompactPath path;
+		std::future<PathAlgorithm::Path> plannedRoute;
+		PathAlgorithm::CancellationTokenPtr routeRequest;
+		std::mutex routeRequestMutex;
+		/**
+			 * Held by the search of a route request, the planners search one route at a time
+			 */
+		std::mutex searchMutex;
 
 		bool acting;
 		bool driving;
@@ -343,6 +436,34 @@ namespace Model
 		mutable std::recursive_mutex robotMutex;
 
 		void sendCopyRobots();
+		/**
+			 * The search of requestRoute and requestReroute
+			 */
+		std::future<PathAlgorithm::Path> request(GoalPtr aGoal,
+												 bool aReroute);
+		/**
+			 * Runs on the thread of a route request
+			 */
+		PathAlgorithm::Path searchRoute(PathAlgorithm::CancellationTokenPtr aToken,
+										const Point &aStart,
+										const Point &aGoal,
+										bool aReroute);
+		/**
+			 * Blocks the footprints of the other robots in the replanner for a route from aPosition
+			 */
+		void blockOtherRobots(const Point &aPosition);
+		/**
+			 * Logs why a route could not be calculated and stops driving, the robot keeps its position
+			 */
+		void routeFailed(const std::exception &anException);
+		/**
+			 * The planner of setSearchMode, the searchMutex must be held or no route requested yet
+			 */
+		void selectPlanner(SearchMode aSearchMode);
+		/**
+			 *
+			 */
+		static SearchMode defaultSearchMode();
 		
 	};
 } // namespace Model
@@ -93,23 +93,27 @@ namespace View
 			getRobot()->setCollisionSize( 75, false);
 		}
 
-		PathAlgorithm::OpenSet openSet = getRobot()->getOpenSet();
-		if (openSet.size() != 0)
+		PathAlgorithm::SearchSnapshotPtr snapshot = getRobot()->getSearchSnapshot();
+		if (snapshot && snapshot->frontier.size() != 0)
 		{
 			dc.SetPen( wxPen( WXSTRING( "PALE GREEN"), borderWidth, wxPENSTYLE_SOLID));
-			for (const PathAlgorithm::Vertex& vertex : openSet)
+			for (const Point& point : snapshot->frontier)
 			{
-				dc.DrawPoint( vertex.asPoint());
+				dc.DrawPoint( point);
 			}
 		}
 
-		PathAlgorithm::Path path = getRobot()->getPath();
+		PathAlgorithm::CompactPath path = getRobot()->getPath();
 		if (path.size() != 0)
 		{
 			dc.SetPen( wxPen( WXSTRING( "BLACK"), borderWidth, wxPENSTYLE_SOLID));
-			for (const PathAlgorithm::Vertex& vertex : path)
+			// Lines, the vertices of an any-angle route are far apart
+			Point previous = path.front().asPoint();
+			for (PathAlgorithm::CompactPath::const_iterator vertex = path.begin() + 1; vertex < path.end(); ++vertex)
 			{
-				dc.DrawPoint( vertex.asPoint());
+				Point point = (*vertex).asPoint();
+				dc.DrawLine( previous, point);
+				previous = point;
 			}
 		}
 
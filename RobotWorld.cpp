@@ -4,6 +4,8 @@
 #include "WayPoint.hpp"
 #include "Goal.hpp"
 #include "Wall.hpp"
+#include "PlanningService.hpp"
+#include "SearchStats.hpp"
 #include <algorithm>
 
 #include "CommunicationService.hpp"
@@ -76,6 +78,7 @@ namespace Model
 	{
 		WallPtr wall(new Model::Wall(aPoint1, aPoint2));
 		walls.push_back(wall);
+		wallsChanged();
 		if (aNotifyObservers == true)
 		{
 			notifyObservers();
@@ -150,6 +153,7 @@ namespace Model
 		if (i != walls.end())
 		{
 			walls.erase(i);
+			wallsChanged();
 
 			if (aNotifyObservers == true)
 			{
@@ -284,11 +288,20 @@ namespace Model
 	{
 		return walls;
 	}
+	/**
+	 *
+	 */
+	void RobotWorld::wallsChanged()
+	{
+		++wallRevision;
+	}
 	/**
 	 *
 	 */
 	void RobotWorld::populate(int aNumberOfWalls /*= 2*/)
 	{
+		startScenario("default");
+
 		RobotWorld::getRobotWorld().newRobot("Robot", Point(163, 111), false);
 
 		RobotWorld::getRobotWorld().newWall(Point(7, 234), Point(419, 234), false);
@@ -302,6 +315,8 @@ namespace Model
 
 	void RobotWorld::populateScenario_1_lhs(int aNumberOfWalls)
 	{
+		startScenario("scenario_1_lhs");
+
 		RobotWorld::getRobotWorld().newRobot("Stein", Point(62, 255), false);
 
 		static Point coordinates[] = {Point(0, 190), Point(186, 190), Point(186, 190), Point(186, 0),
@@ -322,6 +337,8 @@ namespace Model
 
 	void RobotWorld::populateScenario_1_rhs(int aNumberOfWalls)
 	{
+		startScenario("scenario_1_rhs");
+
 		RobotWorld::getRobotWorld().newRobot("Thomas", Point(262, 435), false);
 
 		RobotWorld::getRobotWorld().newGoal("Thomas", Point(258, 37), false);
@@ -333,6 +350,8 @@ namespace Model
 	 */
 	void RobotWorld::populateScenario_2_lhs(int aNumberOfWalls)
 	{
+		startScenario("scenario_2_lhs");
+
 		RobotWorld::getRobotWorld().newRobot("Stein", Point(41, 155), false);
 
 		static Point coordinates[] = {Point(0, 200), Point(300, 200), Point(200, 300), Point(600, 300),
@@ -348,6 +367,8 @@ namespace Model
 	}
 	void RobotWorld::populateScenario_2_rhs(int aNumberOfWalls)
 	{
+		startScenario("scenario_2_rhs");
+
 		RobotWorld::getRobotWorld().newRobot("Thomas", Point(460, 374), false);
 
 		RobotWorld::getRobotWorld().newGoal("Thomas", Point(462, 260), false);
@@ -357,6 +378,8 @@ namespace Model
 
 	void RobotWorld::populateScenario_3_lhs(int aNumberOfWalls)
 	{
+		startScenario("scenario_3_lhs");
+
 		RobotWorld::getRobotWorld().newRobot("Stein", Point(379, 171), false);
 
 		static Point coordinates[] = {
@@ -372,6 +395,8 @@ namespace Model
 	}
 	void RobotWorld::populateScenario_3_rhs(int aNumberOfWalls)
 	{
+		startScenario("scenario_3_rhs");
+
 		RobotWorld::getRobotWorld().newRobot("Thomas", Point(366, 295), false);
 
 		RobotWorld::getRobotWorld().newGoal("Thomas", Point(81, 180), false);
@@ -379,12 +404,63 @@ namespace Model
 		notifyObservers();
 	}
 
+	/**
+	 *
+	 */
+	void RobotWorld::startRobots()
+	{
+		std::vector<PlanningRequest> batch;
+		for (RobotPtr robot : robots)
+		{
+			GoalPtr goal = robot ? getGoal(robot->getName()) : GoalPtr();
+			if (goal && !robot->isActing())
+			{
+				// Cancelled when the robot is stopped before its route is planned
+				batch.push_back(PlanningRequest(robot, goal, robot->newRouteRequest()));
+			}
+		}
+
+		std::vector<std::future<PathAlgorithm::Path>> routes = PlanningService::getPlanningService().plan(batch);
+		for (std::size_t i = 0; i < batch.size(); ++i)
+		{
+			batch[i].robot->startActing(std::move(routes[i]));
+		}
+	}
+	/**
+	 *
+	 */
+	void RobotWorld::logSearchStatistics() const
+	{
+		if (Application::MainApplication::isArgGiven("-search_stats"))
+		{
+			std::string totals = PathAlgorithm::SearchStatistics::getSearchStatistics().asString();
+			if (!totals.empty())
+			{
+				Application::Logger::log("Search totals:\n" + totals);
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	void RobotWorld::startScenario(const std::string &aScenario)
+	{
+		logSearchStatistics();
+		PathAlgorithm::SearchStatistics::getSearchStatistics().setScenario(aScenario);
+	}
+	/**
+	 *
+	 */
 	void RobotWorld::unpopulate(bool aNotifyObservers /*= true*/)
 	{
 		robots.clear();
 		wayPoints.clear();
 		goals.clear();
-		walls.clear();
+		if (!walls.empty())
+		{
+			walls.clear();
+			wallsChanged();
+		}
 
 		if (aNotifyObservers)
 		{
@@ -440,6 +516,7 @@ namespace Model
 															aWall->getObjectId()) == aKeepObjects.end();
 									   }),
 						walls.end());
+			wallsChanged();
 		}
 
 		if (aNotifyObservers)
@@ -766,7 +843,7 @@ namespace Model
 	 *
 	 */
 	RobotWorld::RobotWorld()
-		: communicating(false), robotWorldPtr(this)
+		: communicating(false), wallRevision(0), robotWorldPtr(this)
 	{
 	}
 	/**
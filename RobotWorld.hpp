@@ -1,6 +1,7 @@
 #ifndef ROBOTWORLD_HPP_
 #define ROBOTWORLD_HPP_
 
+#include <atomic>
 #include <vector>
 #include <string>
 #include "Config.hpp"
@@ -125,6 +126,19 @@ public:
 			 *
 			 */
 	const std::vector<WallPtr> &getWalls() const;
+	/**
+			 * The wall revision changes whenever a wall is added, deleted or moved. Anything that is
+			 * derived from the walls (occupancy grids, cached routes...) is valid as long as the revision
+			 * it was built for is the current revision.
+			 */
+	unsigned long getWallRevision() const
+	{
+		return wallRevision;
+	}
+	/**
+			 * Starts a new wall revision, to be called after the geometry of a wall has changed
+			 */
+	void wallsChanged();
 	/**
 			 *
 			 */
@@ -155,6 +169,16 @@ public:
 			 *
 			 */
 	void populateScenario_3_rhs(int aNumberOfWalls);
+	/**
+			 * Starts all robots that have a goal and are not acting yet. Their routes are planned
+			 * in one parallel batch by the PlanningService.
+			 */
+	void startRobots();
+	/**
+			 * Logs the search totals per scenario and robot if the command line argument
+			 * -search_stats is given
+			 */
+	void logSearchStatistics() const;
 	/**
 			 *
 			 */
@@ -241,6 +265,10 @@ public:
 
 protected:
 private:
+	/**
+			 * The searches recorded from now on count for aScenario, the totals so far are logged
+			 */
+	void startScenario(const std::string &aScenario);
 	/**
 			 * The vectors are mutable to allow for lazy instantiation
 			 */
@@ -251,6 +279,7 @@ private:
 
 	bool communicating;
 	bool changed = false;
+	std::atomic<unsigned long> wallRevision;
 	RobotWorldPtr robotWorldPtr;
 };
 } // namespace Model
@@ -904,6 +904,13 @@ void RobotWorldCanvas::handleEndDrag(ShapePtr aShape)
 	if (wayPointShape)
 	{
 		wayPointShape->getWayPoint()->setPosition(wayPointShape->getCentre(), false);
+		// The route its robot is searching leads to where the goal was
+		Model::GoalPtr goal = std::dynamic_pointer_cast<Model::Goal>(wayPointShape->getWayPoint());
+		Model::RobotPtr robot = goal ? Model::RobotWorld::getRobotWorld().getRobot(goal->getName()) : nullptr;
+		if (robot)
+		{
+			robot->cancelRouteRequest();
+		}
 		return;
 	}
 	// Handle the RectangleShapes that are part of a wall
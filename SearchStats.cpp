@@ -0,0 +1,159 @@
+#include "SearchStats.hpp"
+#include "AllocationCounter.hpp"
+#include <algorithm>
+#include <sstream>
+
+namespace PathAlgorithm
+{
+	/**
+	 *
+	 */
+	SearchStats::SearchStats() :
+								expandedCount( 0),
+								generatedCount( 0),
+								peakOpenSize( 0),
+								peakClosedSize( 0),
+								wallCheckCount( 0),
+								allocatedBytes( 0),
+								allocationCount( 0),
+								cacheHit( false),
+								cancelled( false),
+								gridTime( 0),
+								cacheTime( 0),
+								searchTime( 0)
+	{
+	}
+	/**
+	 *
+	 */
+	std::ostream& operator<<(	std::ostream& os,
+								const SearchStats& aSearchStats)
+	{
+		os << "expanded " << aSearchStats.expandedCount << ", generated " << aSearchStats.generatedCount << ", peak open "
+				<< aSearchStats.peakOpenSize << ", peak closed " << aSearchStats.peakClosedSize << ", wall checks "
+				<< aSearchStats.wallCheckCount << ", bytes " << aSearchStats.allocatedBytes;
+		if (AllocationCounter::isCounting())
+		{
+			os << ", allocations " << aSearchStats.allocationCount;
+		}
+		return os << (aSearchStats.cacheHit ? ", cached" : "")
+				<< (aSearchStats.cancelled ? ", cancelled" : "")
+				<< ", grid " << std::chrono::duration_cast< std::chrono::microseconds >(aSearchStats.gridTime).count() << " us, cache "
+				<< std::chrono::duration_cast< std::chrono::microseconds >(aSearchStats.cacheTime).count() << " us, search "
+				<< std::chrono::duration_cast< std::chrono::microseconds >(aSearchStats.searchTime).count() << " us";
+	}
+	/**
+	 *
+	 */
+	SearchStatistics::Totals::Totals() :
+								searchCount( 0),
+								cacheHitCount( 0),
+								cancelledCount( 0),
+								expandedCount( 0),
+								generatedCount( 0),
+								wallCheckCount( 0),
+								peakOpenSize( 0),
+								peakClosedSize( 0),
+								peakAllocatedBytes( 0),
+								allocationCount( 0),
+								gridTime( 0),
+								cacheTime( 0),
+								searchTime( 0),
+								longestSearchTime( 0)
+	{
+	}
+	/**
+	 *
+	 */
+	void SearchStatistics::Totals::add( const SearchStats& aSearchStats)
+	{
+		++searchCount;
+		cacheHitCount += aSearchStats.cacheHit ? 1 : 0;
+		cancelledCount += aSearchStats.cancelled ? 1 : 0;
+		expandedCount += aSearchStats.expandedCount;
+		generatedCount += aSearchStats.generatedCount;
+		wallCheckCount += aSearchStats.wallCheckCount;
+		peakOpenSize = std::max( peakOpenSize, aSearchStats.peakOpenSize);
+		peakClosedSize = std::max( peakClosedSize, aSearchStats.peakClosedSize);
+		peakAllocatedBytes = std::max( peakAllocatedBytes, aSearchStats.allocatedBytes);
+		allocationCount += aSearchStats.allocationCount;
+		gridTime += aSearchStats.gridTime;
+		cacheTime += aSearchStats.cacheTime;
+		searchTime += aSearchStats.searchTime;
+		longestSearchTime = std::max( longestSearchTime, aSearchStats.getTotalTime());
+	}
+	/**
+	 *
+	 */
+	SearchStatistics::SearchStatistics()
+	{
+	}
+	/**
+	 *
+	 */
+	/* static */ SearchStatistics& SearchStatistics::getSearchStatistics()
+	{
+		static SearchStatistics searchStatistics;
+		return searchStatistics;
+	}
+	/**
+	 *
+	 */
+	void SearchStatistics::record(	const std::string& aRobotName,
+									const SearchStats& aSearchStats)
+	{
+		std::lock_guard< std::mutex > lock( statisticsMutex);
+		totals[Key( scenario, aRobotName)].add( aSearchStats);
+	}
+	/**
+	 *
+	 */
+	std::string SearchStatistics::getScenario() const
+	{
+		std::lock_guard< std::mutex > lock( statisticsMutex);
+		return scenario;
+	}
+	/**
+	 *
+	 */
+	void SearchStatistics::setScenario( const std::string& aScenario)
+	{
+		std::lock_guard< std::mutex > lock( statisticsMutex);
+		scenario = aScenario;
+	}
+	/**
+	 *
+	 */
+	void SearchStatistics::clear()
+	{
+		std::lock_guard< std::mutex > lock( statisticsMutex);
+		totals.clear();
+	}
+	/**
+	 *
+	 */
+	std::string SearchStatistics::asString() const
+	{
+		std::lock_guard< std::mutex > lock( statisticsMutex);
+
+		std::ostringstream os;
+		for (const std::pair< const Key, Totals >& entry : totals)
+		{
+			const Totals& robotTotals = entry.second;
+			os << (entry.first.first.empty() ? "-" : entry.first.first) << " " << entry.first.second << ": " << robotTotals.searchCount
+					<< " searches (" << robotTotals.cacheHitCount << " cached, " << robotTotals.cancelledCount << " cancelled), expanded "
+					<< robotTotals.expandedCount << ", generated " << robotTotals.generatedCount << ", wall checks " << robotTotals.wallCheckCount
+					<< ", peak open " << robotTotals.peakOpenSize << ", peak closed " << robotTotals.peakClosedSize << ", peak bytes " << robotTotals.peakAllocatedBytes;
+			if (AllocationCounter::isCounting())
+			{
+				os << ", allocations " << robotTotals.allocationCount;
+			}
+			os << ", grid "
+					<< std::chrono::duration_cast< std::chrono::microseconds >(robotTotals.gridTime).count() << " us, cache "
+					<< std::chrono::duration_cast< std::chrono::microseconds >(robotTotals.cacheTime).count() << " us, search "
+					<< std::chrono::duration_cast< std::chrono::microseconds >(robotTotals.searchTime).count() << " us, longest "
+					<< std::chrono::duration_cast< std::chrono::microseconds >(robotTotals.longestSearchTime).count() << " us" << std::endl;
+		}
+		return os.str();
+	}
+} // namespace PathAlgorithm
@@ -0,0 +1,159 @@
+#ifndef SEARCHSTATS_HPP_
+#define SEARCHSTATS_HPP_
+
+#include "Config.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace PathAlgorithm
+{
+	/**
+	 * What a single search cost
+	 */
+	struct SearchStats
+	{
+			/**
+			 *
+			 */
+			SearchStats();
+			/**
+			 *
+			 */
+			std::chrono::nanoseconds getTotalTime() const
+			{
+				return gridTime + cacheTime + searchTime;
+			}
+
+			unsigned long expandedCount;
+			/**
+			 * The number of vertices added to the openSet
+			 */
+			unsigned long generatedCount;
+			std::size_t peakOpenSize;
+			std::size_t peakClosedSize;
+			/**
+			 * The number of cells looked up in the occupancy grid
+			 */
+			unsigned long wallCheckCount;
+			/**
+			 * The bytes held by the openSet, the workspace and the other search structures of the
+			 * planner after the search
+			 */
+			std::size_t allocatedBytes;
+			/**
+			 * The heap allocations of the search, only counted in a build with COUNT_ALLOCATIONS,
+			 * see AllocationCounter
+			 */
+			unsigned long allocationCount;
+			bool cacheHit;
+			/**
+			 * The search was cancelled before it found a route
+			 */
+			bool cancelled;
+			/**
+			 * Getting the occupancy grid, which is rebuilt if the walls changed
+			 */
+			std::chrono::nanoseconds gridTime;
+			/**
+			 * Looking up and storing the route in the PathCache
+			 */
+			std::chrono::nanoseconds cacheTime;
+			/**
+			 * The search itself, including the construction of the route
+			 */
+			std::chrono::nanoseconds searchTime;
+	};
+	// struct SearchStats
+	/**
+	 *
+	 */
+	std::ostream& operator<<(	std::ostream& os,
+								const SearchStats& aSearchStats);
+
+	/**
+	 * The process-wide totals of the searches per scenario and per robot. The robots record the
+	 * SearchStats of their routes, the scenario is set when the world is populated. With the
+	 * command line argument -search_stats the totals are logged when the next scenario is
+	 * populated and when the application is quit.
+	 */
+	class SearchStatistics
+	{
+		public:
+			/**
+			 * The sums of the counts and times of the searches and the largest peaks
+			 */
+			struct Totals
+			{
+					/**
+					 *
+					 */
+					Totals();
+					/**
+					 *
+					 */
+					void add( const SearchStats& aSearchStats);
+
+					unsigned long searchCount;
+					unsigned long cacheHitCount;
+					unsigned long cancelledCount;
+					unsigned long expandedCount;
+					unsigned long generatedCount;
+					unsigned long wallCheckCount;
+					std::size_t peakOpenSize;
+					std::size_t peakClosedSize;
+					std::size_t peakAllocatedBytes;
+					unsigned long allocationCount;
+					std::chrono::nanoseconds gridTime;
+					std::chrono::nanoseconds cacheTime;
+					std::chrono::nanoseconds searchTime;
+					std::chrono::nanoseconds longestSearchTime;
+			};
+			// struct Totals
+			/**
+			 * (scenario, robot)
+			 */
+			typedef std::pair< std::string, std::string > Key;
+			/**
+			 *
+			 */
+			static SearchStatistics& getSearchStatistics();
+			/**
+			 * Adds aSearchStats to the totals of aRobotName in the current scenario
+			 */
+			void record(	const std::string& aRobotName,
+							const SearchStats& aSearchStats);
+			/**
+			 *
+			 */
+			std::string getScenario() const;
+			/**
+			 * The searches recorded from now on count for aScenario
+			 */
+			void setScenario( const std::string& aScenario);
+			/**
+			 *
+			 */
+			void clear();
+			/**
+			 * @return a line per scenario and robot
+			 */
+			std::string asString() const;
+
+		private:
+			/**
+			 *
+			 */
+			SearchStatistics();
+
+			mutable std::mutex statisticsMutex;
+			std::string scenario;
+			std::map< Key, Totals > totals;
+	}; // class SearchStatistics
+} // namespace PathAlgorithm
+#endif // SEARCHSTATS_HPP_
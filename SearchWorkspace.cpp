@@ -0,0 +1,127 @@
+#include "SearchWorkspace.hpp"
+#include "AStar.hpp"
+#include "CompactPath.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace PathAlgorithm
+{
+	/**
+	 *
+	 */
+	SearchWorkspace::SearchWorkspace() :
+								width( 0),
+								height( 0),
+								generation( 1)
+	{
+	}
+	/**
+	 *
+	 */
+	void SearchWorkspace::resize(	int aWidth,
+									int aHeight)
+	{
+		std::size_t size = static_cast< std::size_t >(std::max( aWidth, 0)) * static_cast< std::size_t >(std::max( aHeight, 0));
+		if (size > visitGeneration.size())
+		{
+			visitGeneration.assign( size, 0);
+			closedGeneration.assign( size, 0);
+			actualCost.resize( size);
+			parent.resize( size);
+		}
+		width = aWidth;
+		height = aHeight;
+		clear();
+	}
+	/**
+	 *
+	 */
+	void SearchWorkspace::clear()
+	{
+		if (generation == std::numeric_limits< unsigned int >::max())
+		{
+			// Only after 4 billion searches...
+			std::fill( visitGeneration.begin(), visitGeneration.end(), 0);
+			std::fill( closedGeneration.begin(), closedGeneration.end(), 0);
+			generation = 0;
+		}
+		++generation;
+	}
+	/**
+	 *
+	 */
+	Path SearchWorkspace::constructPath( unsigned int anIndex) const
+	{
+		std::size_t length = 0;
+		for (unsigned int i = anIndex; i != NoParent; i = parent[i])
+		{
+			++length;
+		}
+
+		Path path( length, Vertex( 0, 0));
+		for (unsigned int i = anIndex; i != NoParent; i = parent[i])
+		{
+			Vertex& vertex = path[--length];
+			vertex.x = xOf( i);
+			vertex.y = yOf( i);
+			vertex.actualCost = actualCost[i];
+			vertex.heuristicCost = actualCost[i];
+		}
+		return path;
+	}
+	/**
+	 *
+	 */
+	CompactPath SearchWorkspace::constructCompactPath( unsigned int anIndex) const
+	{
+		// The runs from anIndex back to the start
+		std::vector< CompactPath::Run > reversed;
+		unsigned int i = anIndex;
+		for (unsigned int p = parent[i]; p != NoParent; i = p, p = parent[i])
+		{
+			int stepX = xOf( i) - xOf( p);
+			int stepY = yOf( i) - yOf( p);
+			if (!reversed.empty() && reversed.back().stepX == stepX && reversed.back().stepY == stepY)
+			{
+				++reversed.back().count;
+			} else
+			{
+				reversed.push_back( CompactPath::Run { 0, 0, stepX, stepY, 1, 0, 0.0 });
+			}
+		}
+
+		CompactPath path;
+		Vertex start( xOf( i), yOf( i));
+		start.actualCost = actualCost[i];
+		path.push_back( start);
+		for (std::vector< CompactPath::Run >::const_reverse_iterator run = reversed.rbegin(); run != reversed.rend(); ++run)
+		{
+			path.addRun( (*run).stepX, (*run).stepY, (*run).count);
+		}
+		return path;
+	}
+	/**
+	 *
+	 */
+	std::size_t SearchWorkspace::getClosedCount() const
+	{
+		std::size_t size = static_cast< std::size_t >(width) * static_cast< std::size_t >(height);
+		return static_cast< std::size_t >(std::count( closedGeneration.begin(), closedGeneration.begin() + static_cast< std::ptrdiff_t >(size), generation));
+	}
+	/**
+	 *
+	 */
+	std::size_t SearchWorkspace::getVisitedCount() const
+	{
+		std::size_t size = static_cast< std::size_t >(width) * static_cast< std::size_t >(height);
+		return static_cast< std::size_t >(std::count( visitGeneration.begin(), visitGeneration.begin() + static_cast< std::ptrdiff_t >(size), generation));
+	}
+	/**
+	 *
+	 */
+	std::size_t SearchWorkspace::getAllocatedBytes() const
+	{
+		return visitGeneration.capacity() * sizeof( unsigned int) + closedGeneration.capacity() * sizeof( unsigned int) +
+			   actualCost.capacity() * sizeof( double) + parent.capacity() * sizeof( unsigned int);
+	}
+} // namespace PathAlgorithm
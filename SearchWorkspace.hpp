@@ -0,0 +1,168 @@
+#ifndef SEARCHWORKSPACE_HPP_
+#define SEARCHWORKSPACE_HPP_
+
+#include "Config.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace PathAlgorithm
+{
+	struct Vertex;
+	typedef std::vector< Vertex > Path;
+	class CompactPath;
+
+	/**
+	 * The per-cell bookkeeping of a grid search (closed flag, actual cost and predecessor)
+	 * in flat arrays indexed by y * width + x.
+	 *
+	 * A cell is only valid if its generation equals the current generation of the workspace,
+	 * so clear() just starts a new generation instead of touching every cell. The arrays are
+	 * only reallocated if the workspace has to grow.
+	 */
+	class SearchWorkspace
+	{
+		public:
+			static const unsigned int NoParent = static_cast< unsigned int >(-1);
+			/**
+			 *
+			 */
+			SearchWorkspace();
+			/**
+			 * Makes the workspace cover the cells [0,aWidth) x [0,aHeight) and clears it
+			 */
+			void resize(	int aWidth,
+							int aHeight);
+			/**
+			 * Invalidates all cells in O(1)
+			 */
+			void clear();
+			/**
+			 *
+			 */
+			int getWidth() const
+			{
+				return width;
+			}
+			/**
+			 *
+			 */
+			int getHeight() const
+			{
+				return height;
+			}
+			/**
+			 *
+			 */
+			bool contains(	int anX,
+							int anY) const
+			{
+				return anX >= 0 && anY >= 0 && anX < width && anY < height;
+			}
+			/**
+			 *
+			 */
+			unsigned int indexOf(	int anX,
+									int anY) const
+			{
+				return static_cast< unsigned int >(anY * width + anX);
+			}
+			/**
+			 *
+			 */
+			int xOf( unsigned int anIndex) const
+			{
+				return static_cast< int >(anIndex % static_cast< unsigned int >(width));
+			}
+			/**
+			 *
+			 */
+			int yOf( unsigned int anIndex) const
+			{
+				return static_cast< int >(anIndex / static_cast< unsigned int >(width));
+			}
+			/**
+			 * @return true if the cell has an actual cost and a predecessor in this generation
+			 */
+			bool isVisited( unsigned int anIndex) const
+			{
+				return visitGeneration[anIndex] == generation;
+			}
+			/**
+			 *
+			 */
+			bool isClosed( unsigned int anIndex) const
+			{
+				return closedGeneration[anIndex] == generation;
+			}
+			/**
+			 *
+			 */
+			void setClosed(	unsigned int anIndex,
+							bool aClosed = true)
+			{
+				closedGeneration[anIndex] = aClosed ? generation : 0;
+			}
+			/**
+			 * Records the actual cost and the predecessor of the cell
+			 */
+			void visit(	unsigned int anIndex,
+						double anActualCost,
+						unsigned int aParent)
+			{
+				visitGeneration[anIndex] = generation;
+				actualCost[anIndex] = anActualCost;
+				parent[anIndex] = aParent;
+			}
+			/**
+			 * Only valid if isVisited( anIndex)
+			 */
+			double getActualCost( unsigned int anIndex) const
+			{
+				return actualCost[anIndex];
+			}
+			/**
+			 * Only valid if isVisited( anIndex)
+			 */
+			unsigned int getParent( unsigned int anIndex) const
+			{
+				return parent[anIndex];
+			}
+			/**
+			 * Walks the parent indices from anIndex back to the start of the search
+			 *
+			 * @return the path from the start to anIndex
+			 */
+			Path constructPath( unsigned int anIndex) const;
+			/**
+			 * Walks the parent indices from anIndex back to the start of the search, keeping only
+			 * the runs of equal steps
+			 *
+			 * @return the compressed path from the start to anIndex
+			 */
+			CompactPath constructCompactPath( unsigned int anIndex) const;
+			/**
+			 * @return the number of cells that are closed in this generation
+			 */
+			std::size_t getClosedCount() const;
+			/**
+			 * @return the number of cells that were visited in this generation
+			 */
+			std::size_t getVisitedCount() const;
+			/**
+			 * @return the bytes held by the per-cell arrays
+			 */
+			std::size_t getAllocatedBytes() const;
+
+		private:
+			int width;
+			int height;
+			unsigned int generation;
+
+			std::vector< unsigned int > visitGeneration;
+			std::vector< unsigned int > closedGeneration;
+			std::vector< double > actualCost;
+			std::vector< unsigned int > parent;
+	}; // class SearchWorkspace
+} // namespace PathAlgorithm
+#endif // SEARCHWORKSPACE_HPP_
@@ -0,0 +1,267 @@
+#include "StateLattice.hpp"
+#include "OccupancyGrid.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <queue>
+
+namespace PathAlgorithm
+{
+	namespace
+	{
+		const int xStep[] = { 1, 2, 1, 1, 0, -1, -1, -2, -1, -2, -1, -1, 0, 1, 1, 2 };
+		const int yStep[] = { 0, 1, 1, 2, 1, 2, 1, 1, 0, -1, -1, -2, -1, -2, -1, -1 };
+		const double Sqrt5 = 2.2360679774997898;
+		const double StepLength[] = { 1.0, Sqrt5, DiagonalStepCost, Sqrt5, 1.0, Sqrt5, DiagonalStepCost, Sqrt5, 1.0, Sqrt5, DiagonalStepCost, Sqrt5, 1.0, Sqrt5, DiagonalStepCost, Sqrt5 };
+
+
+		/**
+		 *
+		 */
+		double Angle( int aHeading)
+		{
+			return std::atan2( static_cast< double >(yStep[aHeading]), static_cast< double >(xStep[aHeading]));
+		}
+	} // namespace
+
+	/* static */ const int StateLattice::HeadingCount;
+	/* static */ constexpr double StateLattice::TurnCost;
+	/**
+	 *
+	 */
+	StateLattice::StateLattice() :
+								robotSize( 0, 0),
+								innerRadius( 0.0),
+								goal( -1, -1),
+								width( 0),
+								height( 0)
+	{
+	}
+	/**
+	 *
+	 */
+	Path StateLattice::search(	Vertex aStart,
+								const Vertex& aGoal,
+								const Size& aRobotSize)
+	{
+		setRobotSize( aRobotSize);
+
+		OccupancyGridPtr inscribedGrid = OccupancyGrid::getOccupancyGrid( static_cast< int >(std::floor( innerRadius)));
+		const DistanceField& distanceField = *inscribedGrid->getDistanceField();
+		setGoal( aGoal.asPoint(), inscribedGrid);
+		if (!contains( aStart.x, aStart.y))
+		{
+			return AStar::search( aStart, aGoal, aRobotSize);
+		}
+
+		resetPoses();
+		std::priority_queue< OpenEntry< int >, std::vector< OpenEntry< int > >, OpenEntryGreater > openSet;
+		auto push = [&]( int anX, int anY, int aHeading, double anActualCost, int aParent)
+		{
+			double heuristicCost = getGoalCost( anX, anY);
+			int& poseNode = poseNodes[static_cast< std::size_t >((anY * width + anX) * HeadingCount + aHeading)];
+			if (std::isinf( heuristicCost) || (poseNode != -1 && nodes[static_cast< std::size_t >(poseNode)].actualCost <= anActualCost))
+			{
+				return;
+			}
+			poseNode = static_cast< int >(nodes.size());
+			nodes.push_back( Node { anX, anY, aHeading, anActualCost, aParent });
+			openSet.push( OpenEntry< int > { anActualCost + heuristicCost, anActualCost, poseNode });
+			countGenerated( openSet.size());
+		};
+
+		for (int heading = 0; heading < HeadingCount; ++heading)
+		{
+			if (poses[static_cast< std::size_t >(heading)].isFree( distanceField, aStart.x, aStart.y))
+			{
+				push( aStart.x, aStart.y, heading, 0.0, -1);
+			}
+		}
+		if (nodes.empty())
+		{
+			return AStar::search( aStart, aGoal, aRobotSize);
+		}
+
+		while (!openSet.empty())
+		{
+			int currentNode = openSet.top().index;
+			openSet.pop();
+			Node current = nodes[static_cast< std::size_t >(currentNode)];
+			if (poseNodes[static_cast< std::size_t >((current.y * width + current.x) * HeadingCount + current.heading)] != currentNode)
+			{
+				// Reached cheaper after it was queued
+				continue;
+			}
+			publishProgress();
+
+			if (current.x == aGoal.x && current.y == aGoal.y)
+			{
+				return constructPath( currentNode);
+			}
+
+			std::size_t heading = static_cast< std::size_t >(current.heading);
+			int x = current.x + xStep[heading];
+			int y = current.y + yStep[heading];
+			if (contains( x, y) && steps[heading].isFree( distanceField, current.x, current.y))
+			{
+				push( x, y, current.heading, current.actualCost + StepLength[heading], currentNode);
+			}
+			int left = (current.heading + HeadingCount - 1) % HeadingCount;
+			if (turns[static_cast< std::size_t >(left)].isFree( distanceField, current.x, current.y))
+			{
+				push( current.x, current.y, left, current.actualCost + TurnCost, currentNode);
+			}
+			int right = (current.heading + 1) % HeadingCount;
+			if (turns[heading].isFree( distanceField, current.x, current.y))
+			{
+				push( current.x, current.y, right, current.actualCost + TurnCost, currentNode);
+			}
+		}
+		std::cerr << "**** No route from " << aStart << " to " << aGoal << " for a robot of " << aRobotSize.x << " by " << aRobotSize.y << std::endl;
+		return Path();
+	}
+	/**
+	 *
+	 */
+	void StateLattice::setGoal(	const Point& aGoal,
+								const OccupancyGridPtr& anOccupancyGrid)
+	{
+		if (aGoal == goal && anOccupancyGrid == occupancyGrid)
+		{
+			return;
+		}
+		resetPoses();
+
+		goal = aGoal;
+		occupancyGrid = anOccupancyGrid;
+		Size bounds = WorldBounds( Vertex( goal), Vertex( goal), *occupancyGrid);
+		width = bounds.x;
+		height = bounds.y;
+
+		std::size_t size = static_cast< std::size_t >(width) * static_cast< std::size_t >(height);
+		goalCosts.assign( size, std::numeric_limits< double >::infinity());
+		goalClosed.assign( size, false);
+		poseNodes.resize( size * HeadingCount, -1);
+		goalOpenSet = GoalOpenSet();
+		if (occupancyGrid->isFree( goal.x, goal.y))
+		{
+			unsigned int goalIndex = static_cast< unsigned int >(goal.y * width + goal.x);
+			goalCosts[goalIndex] = 0.0;
+			goalOpenSet.push( GoalEntry( 0.0, goalIndex));
+		}
+	}
+	/**
+	 *
+	 */
+	double StateLattice::getGoalCost(	int anX,
+										int anY)
+	{
+		unsigned int index = static_cast< unsigned int >(anY * width + anX);
+		unsigned long expandedCount = 0;
+		while (!goalClosed[index] && !goalOpenSet.empty())
+		{
+			GoalEntry current = goalOpenSet.top();
+			goalOpenSet.pop();
+			if (goalClosed[current.second])
+			{
+				continue;
+			}
+			goalClosed[current.second] = true;
+			++expandedCount;
+
+			int x = static_cast< int >(current.second % static_cast< unsigned int >(width));
+			int y = static_cast< int >(current.second / static_cast< unsigned int >(width));
+			for (int heading = 0; heading < HeadingCount; ++heading)
+			{
+				int neighbourX = x + xStep[heading];
+				int neighbourY = y + yStep[heading];
+				if (!contains( neighbourX, neighbourY) || !occupancyGrid->isFree( neighbourX, neighbourY))
+				{
+					continue;
+				}
+				unsigned int neighbourIndex = static_cast< unsigned int >(neighbourY * width + neighbourX);
+				double calculatedCost = current.first + StepLength[heading];
+				if (calculatedCost < goalCosts[neighbourIndex])
+				{
+					goalCosts[neighbourIndex] = calculatedCost;
+					goalOpenSet.push( GoalEntry( calculatedCost, neighbourIndex));
+				}
+			}
+		}
+		OccupancyGrid::countWallChecks( expandedCount * HeadingCount);
+		// Still infinite if the Dijkstra search ran out without reaching the cell
+		return goalCosts[index];
+	}
+	/**
+	 *
+	 */
+	void StateLattice::resetPoses()
+	{
+		for (const Node& node : nodes)
+		{
+			poseNodes[static_cast< std::size_t >((node.y * width + node.x) * HeadingCount + node.heading)] = -1;
+		}
+		nodes.clear();
+	}
+	/**
+	 *
+	 */
+	Path StateLattice::constructPath( int aNode) const
+	{
+		Path path;
+		for (int i = aNode; i != -1; i = nodes[static_cast< std::size_t >(i)].parent)
+		{
+			const Node& node = nodes[static_cast< std::size_t >(i)];
+			if (path.empty() || path.back().x != node.x || path.back().y != node.y)
+			{
+				Vertex vertex( node.x, node.y);
+				vertex.actualCost = vertex.heuristicCost = node.actualCost;
+				path.push_back( vertex);
+			}
+		}
+		std::reverse( path.begin(), path.end());
+		return path;
+	}
+	/**
+	 *
+	 */
+	std::size_t StateLattice::getAllocatedBytes() const
+	{
+		return AStar::getAllocatedBytes() + goalCosts.capacity() * sizeof( double) + goalClosed.capacity() / 8 + nodes.capacity() * sizeof( Node) + poseNodes.capacity() * sizeof( int);
+	}
+	/**
+	 *
+	 */
+	/* static */ Point StateLattice::getStep( int aHeading)
+	{
+		return Point( xStep[aHeading], yStep[aHeading]);
+	}
+	/**
+	 *
+	 */
+	void StateLattice::setRobotSize( const Size& aRobotSize)
+	{
+		if (aRobotSize == robotSize && !poses.empty())
+		{
+			return;
+		}
+		robotSize = aRobotSize;
+		poses.clear();
+		steps.clear();
+		turns.clear();
+		innerRadius = std::numeric_limits< double >::infinity();
+		for (int heading = 0; heading < HeadingCount; ++heading)
+		{
+			double angle = Angle( heading);
+			// The shortest way round to the next heading
+			double nextAngle = angle + std::remainder( Angle( (heading + 1) % HeadingCount) - angle, 2.0 * std::acos( -1.0));
+
+			poses.push_back( Footprint( robotSize, angle));
+			steps.push_back( Footprint( robotSize, angle, angle, xStep[heading], yStep[heading]));
+			turns.push_back( Footprint( robotSize, angle, nextAngle, 0.0, 0.0));
+			innerRadius = std::min( innerRadius, poses.back().getInnerRadius());
+		}
+	}
+} // namespace PathAlgorithm
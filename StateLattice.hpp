@@ -0,0 +1,150 @@
+#ifndef STATELATTICE_HPP_
+#define STATELATTICE_HPP_
+
+#include "Config.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "AStar.hpp"
+#include "Footprint.hpp"
+#include "OccupancyGrid.hpp"
+
+namespace PathAlgorithm
+{
+	/**
+	 * A* over the poses (x, y, heading) of a rectangular robot instead of a round one, so a robot
+	 * fits through a gap as wide as the robot rather than as wide as its circumscribed circle.
+	 *
+	 * The 16 headings are the directions of the steps to the cells up to two cells away that are
+	 * not a multiple of a shorter step. A pose either drives one step along its heading or turns
+	 * on the spot to the next heading on either side, as a Robot does at the vertices of its
+	 * route. A step or a turn is allowed if the Footprint it sweeps is free, the footprints of
+	 * all steps and turns are computed once per robot size.
+	 *
+	 * The heuristic is the cost of the route of the circle inscribed in the robot with the same
+	 * steps but without the turns, from a Dijkstra search from the goal that is only taken as far
+	 * as the searches to the goal need.
+	 *
+	 * The robot may start in any heading, turning on the spot before it drives off is not
+	 * checked. A start where the robot fits in no heading is searched with AStar.
+	 */
+	class StateLattice : public AStar
+	{
+		public:
+			/**
+			 *
+			 */
+			static const int HeadingCount = 16;
+			/**
+			 * The cost of a turn to the next heading, in cells driven
+			 */
+			static constexpr double TurnCost = 1.0;
+			/**
+			 *
+			 */
+			StateLattice();
+			using AStar::search;
+			/**
+			 *
+			 */
+			virtual Path search(Vertex aStart,
+								const Vertex& aGoal,
+								const Size& aRobotSize);
+			/**
+			 * The PathCache holds routes of round robots
+			 */
+			virtual bool isCacheable() const
+			{
+				return false;
+			}
+			/**
+			 *
+			 */
+			virtual std::size_t getAllocatedBytes() const;
+			/**
+			 * @return the step of aHeading
+			 */
+			static Point getStep( int aHeading);
+
+		private:
+			/**
+			 *
+			 */
+			struct Node
+			{
+					int x;
+					int y;
+					int heading;
+					double actualCost;
+					int parent;
+			};
+			// struct Node
+			/**
+			 * Computes the footprints of aRobotSize unless they are already there
+			 */
+			void setRobotSize( const Size& aRobotSize);
+			/**
+			 * Starts the heuristic of aGoal on anOccupancyGrid, the grid of the inscribed circle,
+			 * unless it is already there
+			 */
+			void setGoal(	const Point& aGoal,
+							const OccupancyGridPtr& anOccupancyGrid);
+			/**
+			 * @return the heuristic of the cell, the Dijkstra search from the goal is resumed until
+			 * it has reached the cell (Silver's Reverse Resumable A*)
+			 */
+			double getGoalCost(	int anX,
+								int anY);
+			/**
+			 * Forgets the nodes of the last search
+			 */
+			void resetPoses();
+			/**
+			 * The route to aNode of the last search, the turns on the spot are not in it
+			 */
+			Path constructPath( int aNode) const;
+			/**
+			 *
+			 */
+			bool contains(	int anX,
+							int anY) const
+			{
+				return anX >= 0 && anY >= 0 && anX < width && anY < height;
+			}
+
+			Size robotSize;
+			/**
+			 * Per heading: the robot standing still, driving a step and turning to the next heading
+			 */
+			std::vector< Footprint > poses;
+			std::vector< Footprint > steps;
+			std::vector< Footprint > turns;
+			double innerRadius;
+
+			Point goal;
+			OccupancyGridPtr occupancyGrid;
+			int width;
+			int height;
+			/**
+			 * The Dijkstra search from the goal with the steps of the lattice but without turns, for
+			 * the inscribed circle. The route back is the same, so the costs of the closed cells are
+			 * the costs of their routes to the goal.
+			 */
+			typedef std::pair< double, unsigned int > GoalEntry;
+			typedef std::priority_queue< GoalEntry, std::vector< GoalEntry >, std::greater< GoalEntry > > GoalOpenSet;
+			GoalOpenSet goalOpenSet;
+			std::vector< double > goalCosts;
+			std::vector< bool > goalClosed;
+			/**
+			 * The nodes of the last search, and per pose the index of its node, -1 if the pose was
+			 * not reached. Only the poses of the nodes are reset for the next search.
+			 */
+			std::vector< Node > nodes;
+			std::vector< int > poseNodes;
+	}; // class StateLattice
+} // namespace PathAlgorithm
+#endif // STATELATTICE_HPP_
@@ -0,0 +1,104 @@
+#include "ThetaStar.hpp"
+#include "OccupancyGrid.hpp"
+#include <iostream>
+
+namespace PathAlgorithm
+{
+	/**
+	 *
+	 */
+	Path ThetaStar::search(	Vertex aStart,
+							const Vertex& aGoal,
+							const Size& aRobotSize)
+	{
+		getOS().clear();
+
+		OccupancyGridPtr occupancyGrid = OccupancyGrid::getOccupancyGrid( FreeRadius( aRobotSize));
+
+		SearchWorkspace& workspace = getWS();
+		Size bounds = WorldBounds( aStart, aGoal, *occupancyGrid);
+		workspace.resize( bounds.x, bounds.y);
+		if (!workspace.contains( aStart.x, aStart.y) || !workspace.contains( aGoal.x, aGoal.y))
+		{
+			std::cerr << "**** No route from " << aStart << " to " << aGoal << ": outside of the world" << std::endl;
+			return Path();
+		}
+
+		aStart.actualCost = 0.0;
+		aStart.heuristicCost = aStart.actualCost + HeuristicCost( aStart, aGoal);
+
+		workspace.visit( workspace.indexOf( aStart.x, aStart.y), aStart.actualCost, SearchWorkspace::NoParent);
+		addToOpenSet( aStart);
+
+		while (!getOS().empty())
+		{
+			Vertex current = getOS().top();
+			unsigned int currentIndex = workspace.indexOf( current.x, current.y);
+
+			if (current.equalPoint( aGoal))
+			{
+				// The parents are the ends of the segments
+				return workspace.constructPath( currentIndex);
+			}
+
+			addToClosedSet( current);
+			removeFirstFromOpenSet();
+			publishProgress( currentIndex);
+
+			unsigned int parentIndex = workspace.getParent( currentIndex);
+			Vertex parent( current);
+			if (parentIndex != SearchWorkspace::NoParent)
+			{
+				parent = Vertex( workspace.xOf( parentIndex), workspace.yOf( parentIndex));
+				parent.actualCost = workspace.getActualCost( parentIndex);
+			}
+
+			Neighbours neighbours;
+			GetNeighbours( current, *occupancyGrid, neighbours);
+			for (const Neighbour& candidate : neighbours)
+			{
+				if (!workspace.contains( candidate.x, candidate.y))
+				{
+					continue;
+				}
+				unsigned int neighbourIndex = workspace.indexOf( candidate.x, candidate.y);
+
+				// The heuristic is consistent, a closed vertex has its lowest cost already
+				if (workspace.isClosed( neighbourIndex))
+				{
+					continue;
+				}
+
+				Vertex neighbour( candidate.x, candidate.y);
+				unsigned int via = currentIndex;
+				double calculatedActualCost = current.actualCost + (candidate.diagonal ? DiagonalStepCost : 1.0);
+				if (parentIndex != SearchWorkspace::NoParent && occupancyGrid->isLineFree( parent.asPoint(), neighbour.asPoint()))
+				{
+					via = parentIndex;
+					calculatedActualCost = parent.actualCost + ActualCost( parent, neighbour);
+				}
+
+				if (workspace.isVisited( neighbourIndex) && workspace.getActualCost( neighbourIndex) <= calculatedActualCost)
+				{
+					continue;
+				}
+				bool inOpenSet = workspace.isVisited( neighbourIndex);
+
+				neighbour.actualCost = calculatedActualCost;
+				neighbour.heuristicCost = calculatedActualCost + HeuristicCost( neighbour, aGoal);
+				workspace.visit( neighbourIndex, calculatedActualCost, via);
+
+				if (inOpenSet)
+				{
+					updateInOpenSet( neighbour);
+				} else
+				{
+					addToOpenSet( neighbour);
+				}
+			}
+		}
+
+		std::cerr << "**** No route from " << aStart << " to " << aGoal << std::endl;
+		return Path();
+	}
+} // namespace PathAlgorithm
@@ -0,0 +1,38 @@
+#ifndef THETASTAR_HPP_
+#define THETASTAR_HPP_
+
+#include "Config.hpp"
+
+#include "AStar.hpp"
+
+namespace PathAlgorithm
+{
+	/**
+	 * Theta* (Nash, Daniel, Koenig and Felner, 2007): any-angle search on the same grid as AStar.
+	 *
+	 * When a neighbour is reached it is connected straight to the parent of the expanded vertex if
+	 * the occupancy grid has a free line of sight between them, otherwise to the expanded vertex
+	 * itself. The route is therefore a short list of vertices connected by straight segments of
+	 * any angle instead of a staircase of neighbouring cells, and it is usually shorter too.
+	 */
+	class ThetaStar : public AStar
+	{
+		public:
+			using AStar::search;
+			/**
+			 *
+			 */
+			virtual Path search(Vertex aStart,
+								const Vertex& aGoal,
+								const Size& aRobotSize);
+			/**
+			 * The straight segments between the vertices in sight of each other usually make the
+			 * route shorter than the AStar route the PathCache holds for the same key
+			 */
+			virtual bool isCacheable() const
+			{
+				return false;
+			}
+	}; // class ThetaStar
+} // namespace PathAlgorithm
+#endif // THETASTAR_HPP_
@@ -0,0 +1,436 @@
+#include "VisibilityGraph.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <queue>
+
+namespace PathAlgorithm
+{
+	namespace
+	{
+		/**
+		 * The squared distance from aPoint to the segment from aFrom to aTo
+		 */
+		double PointSegmentDistanceSquared(	const Point& aPoint,
+											const Point& aFrom,
+											const Point& aTo)
+		{
+			double dX = aTo.x - aFrom.x;
+			double dY = aTo.y - aFrom.y;
+			double lengthSquared = dX * dX + dY * dY;
+			double t = 0.0;
+			if (lengthSquared > 0.0)
+			{
+				t = std::min( std::max( ((aPoint.x - aFrom.x) * dX + (aPoint.y - aFrom.y) * dY) / lengthSquared, 0.0), 1.0);
+			}
+			double x = aFrom.x + t * dX - aPoint.x;
+			double y = aFrom.y + t * dY - aPoint.y;
+			return x * x + y * y;
+		}
+		/**
+		 * @return > 0 if aPoint lies left of the line from aFrom to aTo, < 0 if right and 0 if on it
+		 */
+		long Orientation(	const Point& aFrom,
+							const Point& aTo,
+							const Point& aPoint)
+		{
+			return static_cast< long >(aTo.x - aFrom.x) * (aPoint.y - aFrom.y) - static_cast< long >(aTo.y - aFrom.y) * (aPoint.x - aFrom.x);
+		}
+		/**
+		 * The squared distance between the segments (a1,a2) and (b1,b2), 0 if they intersect
+		 */
+		double SegmentDistanceSquared(	const Point& a1,
+										const Point& a2,
+										const Point& b1,
+										const Point& b2)
+		{
+			long o1 = Orientation( a1, a2, b1);
+			long o2 = Orientation( a1, a2, b2);
+			long o3 = Orientation( b1, b2, a1);
+			long o4 = Orientation( b1, b2, a2);
+			if (((o1 > 0 && o2 < 0) || (o1 < 0 && o2 > 0)) && ((o3 > 0 && o4 < 0) || (o3 < 0 && o4 > 0)))
+			{
+				return 0.0;
+			}
+			// Otherwise the closest points include an end point, also for touching segments
+			return std::min( std::min( PointSegmentDistanceSquared( b1, a1, a2), PointSegmentDistanceSquared( b2, a1, a2)),
+							 std::min( PointSegmentDistanceSquared( a1, b1, b2), PointSegmentDistanceSquared( a2, b1, b2)));
+		}
+	} // namespace
+
+	/* static */ const int VisibilityGraph::NoWall;
+	/* static */ constexpr double VisibilityGraph::Clearance;
+	/**
+	 *
+	 */
+	VisibilityGraph::VisibilityGraph( int aRadius) :
+								radius( aRadius),
+								wallRevision( static_cast< unsigned long >(-1))
+	{
+	}
+	/**
+	 *
+	 */
+	/* static */ VisibilityGraphPtr VisibilityGraph::getVisibilityGraph( int aRadius)
+	{
+		static std::mutex registryMutex;
+		static std::map< int, std::shared_ptr< VisibilityGraph > > registry;
+
+		OccupancyGridPtr occupancyGrid = OccupancyGrid::getOccupancyGrid( aRadius);
+
+		std::lock_guard< std::mutex > lock( registryMutex);
+
+		std::shared_ptr< VisibilityGraph >& graph = registry[aRadius];
+		if (!graph)
+		{
+			graph = std::make_shared< VisibilityGraph >( aRadius);
+		}
+		if (graph->getWallRevision() != occupancyGrid->getWallRevision())
+		{
+			// Searches that still use the graph must not see it change
+			if (graph.use_count() > 1)
+			{
+				graph = std::make_shared< VisibilityGraph >( *graph);
+			}
+			graph->synchronise( occupancyGrid);
+		}
+		return graph;
+	}
+	/**
+	 *
+	 */
+	void VisibilityGraph::synchronise( const OccupancyGridPtr& anOccupancyGrid)
+	{
+		const std::vector< DistanceField::Segment >& segments = anOccupancyGrid->getDistanceField()->getSegments();
+
+		std::vector< DistanceField::Segment > presentSegments;
+		for (const Wall& wall : walls)
+		{
+			if (wall.present)
+			{
+				presentSegments.push_back( wall.segment);
+			}
+		}
+		std::sort( presentSegments.begin(), presentSegments.end(), SegmentLess);
+
+		std::vector< DistanceField::Segment > removed;
+		std::set_difference(	presentSegments.begin(), presentSegments.end(),
+								segments.begin(), segments.end(),
+								std::back_inserter( removed), SegmentLess);
+		std::vector< DistanceField::Segment > added;
+		std::set_difference(	segments.begin(), segments.end(),
+								presentSegments.begin(), presentSegments.end(),
+								std::back_inserter( added), SegmentLess);
+
+		for (const DistanceField::Segment& segment : removed)
+		{
+			for (std::size_t wall = 0; wall < walls.size(); ++wall)
+			{
+				if (walls[wall].present && walls[wall].segment == segment)
+				{
+					removeWall( static_cast< int >(wall));
+					break;
+				}
+			}
+		}
+		for (const DistanceField::Segment& segment : added)
+		{
+			addWall( segment);
+		}
+
+		occupancyGrid = anOccupancyGrid;
+		wallRevision = anOccupancyGrid->getWallRevision();
+	}
+	/**
+	 *
+	 */
+	bool VisibilityGraph::isVisible(	const Point& aFrom,
+										const Point& aTo) const
+	{
+		if (findBlocker( aFrom, aTo) == NoWall)
+		{
+			return true;
+		}
+		if (findCoveringWall( aFrom) != NoWall || findCoveringWall( aTo) != NoWall)
+		{
+			return occupancyGrid->isLineFree( aFrom, aTo);
+		}
+		return false;
+	}
+	/**
+	 *
+	 */
+	void VisibilityGraph::removeWall( int aWall)
+	{
+		walls[static_cast< std::size_t >(aWall)].present = false;
+		for (Corner& corner : corners)
+		{
+			if (corner.wall == aWall)
+			{
+				corner.wall = NoWall;
+			}
+		}
+
+		// The pairs it was in the way of
+		for (std::size_t i = 0; i < corners.size(); ++i)
+		{
+			if (!isClear( i))
+			{
+				continue;
+			}
+			for (std::size_t j = i + 1; j < corners.size(); ++j)
+			{
+				if (isClear( j) && blockers[i][j] == aWall)
+				{
+					blockers[i][j] = blockers[j][i] = findBlocker( corners[i].point, corners[j].point);
+				}
+			}
+		}
+
+		// The corners it was too close to
+		for (std::size_t i = 0; i < corners.size(); ++i)
+		{
+			if (corners[i].wall != NoWall && corners[i].blockedBy == aWall)
+			{
+				corners[i].blockedBy = findCoveringWall( corners[i].point);
+				if (isClear( i))
+				{
+					connect( i);
+				}
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	void VisibilityGraph::addWall( const DistanceField::Segment& aSegment)
+	{
+		std::size_t wall = 0;
+		while (wall < walls.size() && walls[wall].present)
+		{
+			++wall;
+		}
+		if (wall == walls.size())
+		{
+			walls.push_back( Wall());
+		}
+		walls[wall] = Wall { aSegment, true };
+		int newWall = static_cast< int >(wall);
+
+		// The corners it is too close to and the pairs it comes between
+		for (std::size_t i = 0; i < corners.size(); ++i)
+		{
+			if (isClear( i) && findCoveringWall( corners[i].point) == newWall)
+			{
+				corners[i].blockedBy = newWall;
+			}
+		}
+		for (std::size_t i = 0; i < corners.size(); ++i)
+		{
+			if (!isClear( i))
+			{
+				continue;
+			}
+			for (std::size_t j = i + 1; j < corners.size(); ++j)
+			{
+				if (isClear( j) && blockers[i][j] == NoWall && blocks( newWall, corners[i].point, corners[j].point))
+				{
+					blockers[i][j] = blockers[j][i] = newWall;
+				}
+			}
+		}
+
+		// Its own corners, diagonally out from its end points
+		const Point& from = aSegment.first;
+		const Point& to = aSegment.second;
+		double length = std::sqrt( static_cast< double >((to.x - from.x) * (to.x - from.x) + (to.y - from.y) * (to.y - from.y)));
+		double dX = length > 0.0 ? (to.x - from.x) / length : 1.0;
+		double dY = length > 0.0 ? (to.y - from.y) / length : 0.0;
+		double offset = radius + Clearance + 1.0;
+		const Point points[] = { Point( static_cast< int >(std::round( from.x - offset * (dX + dY))), static_cast< int >(std::round( from.y - offset * (dY - dX)))),
+								 Point( static_cast< int >(std::round( from.x - offset * (dX - dY))), static_cast< int >(std::round( from.y - offset * (dY + dX)))),
+								 Point( static_cast< int >(std::round( to.x + offset * (dX + dY))), static_cast< int >(std::round( to.y + offset * (dY - dX)))),
+								 Point( static_cast< int >(std::round( to.x + offset * (dX - dY))), static_cast< int >(std::round( to.y + offset * (dY + dX)))) };
+		for (const Point& point : points)
+		{
+			std::size_t corner = allocateCorner();
+			corners[corner] = Corner { point, newWall, findCoveringWall( point) };
+			if (isClear( corner))
+			{
+				connect( corner);
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	std::size_t VisibilityGraph::allocateCorner()
+	{
+		for (std::size_t i = 0; i < corners.size(); ++i)
+		{
+			if (corners[i].wall == NoWall)
+			{
+				return i;
+			}
+		}
+		corners.push_back( Corner { Point(), NoWall, NoWall });
+		for (std::vector< int >& row : blockers)
+		{
+			row.push_back( NoWall);
+		}
+		blockers.push_back( std::vector< int >( corners.size(), NoWall));
+		return corners.size() - 1;
+	}
+	/**
+	 *
+	 */
+	void VisibilityGraph::connect( std::size_t aCorner)
+	{
+		for (std::size_t i = 0; i < corners.size(); ++i)
+		{
+			if (i != aCorner && isClear( i))
+			{
+				blockers[aCorner][i] = blockers[i][aCorner] = findBlocker( corners[aCorner].point, corners[i].point);
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	int VisibilityGraph::findBlocker(	const Point& aFrom,
+										const Point& aTo) const
+	{
+		for (std::size_t wall = 0; wall < walls.size(); ++wall)
+		{
+			if (walls[wall].present && blocks( static_cast< int >(wall), aFrom, aTo))
+			{
+				return static_cast< int >(wall);
+			}
+		}
+		return NoWall;
+	}
+	/**
+	 *
+	 */
+	int VisibilityGraph::findCoveringWall( const Point& aPoint) const
+	{
+		double clearance = radius + Clearance;
+		for (std::size_t wall = 0; wall < walls.size(); ++wall)
+		{
+			if (walls[wall].present && PointSegmentDistanceSquared( aPoint, walls[wall].segment.first, walls[wall].segment.second) < clearance * clearance)
+			{
+				return static_cast< int >(wall);
+			}
+		}
+		return NoWall;
+	}
+	/**
+	 *
+	 */
+	bool VisibilityGraph::blocks(	int aWall,
+									const Point& aFrom,
+									const Point& aTo) const
+	{
+		double clearance = radius + Clearance;
+		const DistanceField::Segment& segment = walls[static_cast< std::size_t >(aWall)].segment;
+		return SegmentDistanceSquared( aFrom, aTo, segment.first, segment.second) < clearance * clearance;
+	}
+	/**
+	 *
+	 */
+	Path VisibilityGraphSearch::search(	Vertex aStart,
+										const Vertex& aGoal,
+										const Size& aRobotSize)
+	{
+		VisibilityGraphPtr graph = VisibilityGraph::getVisibilityGraph( FreeRadius( aRobotSize));
+		const OccupancyGrid& occupancyGrid = *graph->getOccupancyGrid();
+		if (aStart.x < 0 || aStart.y < 0 || aGoal.x < 0 || aGoal.y < 0 || !occupancyGrid.isFree( aStart.x, aStart.y) || !occupancyGrid.isFree( aGoal.x, aGoal.y))
+		{
+			// AStar knows what to do with a robot that overlaps a wall, and why there is no route
+			return AStar::search( aStart, aGoal, aRobotSize);
+		}
+
+		// The corners, then the start and the goal
+		std::size_t cornerCount = graph->getCornerCount();
+		std::size_t startNode = cornerCount;
+		std::size_t goalNode = cornerCount + 1;
+		std::vector< Point > points( cornerCount + 2);
+		for (std::size_t i = 0; i < cornerCount; ++i)
+		{
+			points[i] = graph->getCorner( i);
+		}
+		points[startNode] = aStart.asPoint();
+		points[goalNode] = aGoal.asPoint();
+
+		std::vector< double > costs( points.size(), std::numeric_limits< double >::infinity());
+		std::vector< std::size_t > parents( points.size(), startNode);
+		std::vector< bool > closed( points.size(), false);
+
+		typedef std::pair< double, std::size_t > OpenEntry;
+		std::priority_queue< OpenEntry, std::vector< OpenEntry >, std::greater< OpenEntry > > openSet;
+		costs[startNode] = 0.0;
+		openSet.push( OpenEntry( HeuristicCost( aStart, aGoal), startNode));
+		while (!openSet.empty())
+		{
+			std::size_t current = openSet.top().second;
+			openSet.pop();
+			if (closed[current])
+			{
+				continue;
+			}
+			closed[current] = true;
+			publishProgress();
+
+			if (current == goalNode)
+			{
+				Path path;
+				for (std::size_t node = goalNode; node != startNode; node = parents[node])
+				{
+					Vertex vertex( points[node]);
+					vertex.actualCost = vertex.heuristicCost = costs[node];
+					path.push_back( vertex);
+				}
+				path.push_back( Vertex( points[startNode]));
+				std::reverse( path.begin(), path.end());
+				return path;
+			}
+
+			for (std::size_t next = 0; next < points.size(); ++next)
+			{
+				if (closed[next] || next == startNode)
+				{
+					continue;
+				}
+				bool visible = false;
+				if (next == goalNode || current == startNode)
+				{
+					visible = (next == goalNode || graph->isUsable( next)) && graph->isVisible( points[current], points[next]);
+				} else
+				{
+					visible = graph->isUsable( next) && graph->isVisible( current, next);
+				}
+				if (!visible)
+				{
+					continue;
+				}
+
+				double cost = costs[current] + ActualCost( Vertex( points[current]), Vertex( points[next]));
+				if (cost < costs[next])
+				{
+					costs[next] = cost;
+					parents[next] = current;
+					openSet.push( OpenEntry( cost + HeuristicCost( Vertex( points[next]), aGoal), next));
+					countGenerated( openSet.size());
+				}
+			}
+		}
+
+		// A gap too narrow for the clearance of the graph
+		return AStar::search( aStart, aGoal, aRobotSize);
+	}
+} // namespace PathAlgorithm
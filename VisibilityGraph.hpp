@@ -0,0 +1,209 @@
+#ifndef VISIBILITYGRAPH_HPP_
+#define VISIBILITYGRAPH_HPP_
+
+#include "Config.hpp"
+
+#include <memory>
+#include <vector>
+
+#include "AStar.hpp"
+#include "DistanceField.hpp"
+#include "OccupancyGrid.hpp"
+
+namespace PathAlgorithm
+{
+	class VisibilityGraph;
+	typedef std::shared_ptr< const VisibilityGraph > VisibilityGraphPtr;
+
+	/**
+	 * The visibility graph of the walls for a robot with a radius: the vertices are the corners
+	 * of the rectangles around the walls, a little further out than the radius, and two corners
+	 * are connected if the straight segment between them keeps that far from every wall. The
+	 * graph only depends on the number of walls, not on the size of the world.
+	 *
+	 * The graph is changed wall by wall. For every corner that lies too close to a wall and for
+	 * every pair of corners that can not see each other one wall in the way is remembered, so a
+	 * removed wall only has the corners and pairs it was in the way of tested again and an added
+	 * wall only tests the pairs that could see each other.
+	 */
+	class VisibilityGraph
+	{
+		public:
+			/**
+			 * A wall that is in the way of nothing
+			 */
+			static const int NoWall = -1;
+			/**
+			 * The distance beyond the radius that the edges keep from the walls. It covers rounding
+			 * the corners and the positions of a driving robot to whole cells, and the walls being
+			 * rasterised in the grid.
+			 */
+			static constexpr double Clearance = 2.0;
+			/**
+			 *
+			 */
+			explicit VisibilityGraph( int aRadius);
+			/**
+			 * @return the graph for aRadius that is synchronised with the current occupancy grid for
+			 * aRadius. The graph is shared, a returned graph is never changed anymore.
+			 */
+			static VisibilityGraphPtr getVisibilityGraph( int aRadius);
+			/**
+			 * Brings the graph in line with the walls of anOccupancyGrid, only the walls that differ
+			 * from the walls of the previous synchronisation are removed or added
+			 */
+			void synchronise( const OccupancyGridPtr& anOccupancyGrid);
+			/**
+			 * @return the number of corner slots, some of which may not be usable
+			 */
+			std::size_t getCornerCount() const
+			{
+				return corners.size();
+			}
+			/**
+			 *
+			 */
+			const Point& getCorner( std::size_t aCorner) const
+			{
+				return corners[aCorner].point;
+			}
+			/**
+			 * @return true if aCorner is a vertex of the graph: it belongs to a wall, it is clear of
+			 * all walls and it lies in the world
+			 */
+			bool isUsable( std::size_t aCorner) const
+			{
+				const Corner& corner = corners[aCorner];
+				return corner.wall != NoWall && corner.blockedBy == NoWall && corner.point.x >= 0 && corner.point.y >= 0
+						&& corner.point.x < occupancyGrid->getWidth() && corner.point.y < occupancyGrid->getHeight();
+			}
+			/**
+			 * @return true if the usable corners aFrom and aTo are connected
+			 */
+			bool isVisible(	std::size_t aFrom,
+							std::size_t aTo) const
+			{
+				return blockers[aFrom][aTo] == NoWall;
+			}
+			/**
+			 * @return true if a robot can drive straight from aFrom to aTo. A point that is closer
+			 * to a wall than the edges of the graph, such as a robot that stopped next to a wall, is
+			 * checked in the occupancy grid instead.
+			 */
+			bool isVisible(	const Point& aFrom,
+							const Point& aTo) const;
+			/**
+			 *
+			 */
+			const OccupancyGridPtr& getOccupancyGrid() const
+			{
+				return occupancyGrid;
+			}
+			/**
+			 *
+			 */
+			unsigned long getWallRevision() const
+			{
+				return wallRevision;
+			}
+
+		private:
+			/**
+			 *
+			 */
+			struct Wall
+			{
+					DistanceField::Segment segment;
+					bool present;
+			};
+			// struct Wall
+			/**
+			 * A corner slot, free if wall is NoWall
+			 */
+			struct Corner
+			{
+					Point point;
+					int wall;
+					/**
+					 * A wall that is too close to the corner, NoWall if the corner is clear
+					 */
+					int blockedBy;
+			};
+			// struct Corner
+			/**
+			 *
+			 */
+			void removeWall( int aWall);
+			/**
+			 *
+			 */
+			void addWall( const DistanceField::Segment& aSegment);
+			/**
+			 * @return a free corner slot, the matrix of the blockers grows if there is none
+			 */
+			std::size_t allocateCorner();
+			/**
+			 * Finds the blockers of aCorner and all other clear corners
+			 */
+			void connect( std::size_t aCorner);
+			/**
+			 * @return a wall that is too close to the segment from aFrom to aTo, NoWall if there is none
+			 */
+			int findBlocker(	const Point& aFrom,
+								const Point& aTo) const;
+			/**
+			 * @return a wall that is too close to aPoint, NoWall if there is none
+			 */
+			int findCoveringWall( const Point& aPoint) const;
+			/**
+			 * @return true if aWall is too close to the segment from aFrom to aTo
+			 */
+			bool blocks(	int aWall,
+							const Point& aFrom,
+							const Point& aTo) const;
+			/**
+			 * @return true if the corner slot holds a clear corner, whether or not it lies in the world
+			 */
+			bool isClear( std::size_t aCorner) const
+			{
+				return corners[aCorner].wall != NoWall && corners[aCorner].blockedBy == NoWall;
+			}
+
+			int radius;
+			unsigned long wallRevision;
+			OccupancyGridPtr occupancyGrid;
+
+			std::vector< Wall > walls;
+			std::vector< Corner > corners;
+			/**
+			 * A wall in the way between two clear corners, NoWall if they see each other
+			 */
+			std::vector< std::vector< int > > blockers;
+	}; // class VisibilityGraph
+
+	/**
+	 * A* over the VisibilityGraph: the start and the goal are connected to the corners they see
+	 * and the route is the list of corners in between. If the graph has no route, e.g. because a
+	 * gap is only a little wider than the robot, the route is searched in the grid by AStar.
+	 */
+	class VisibilityGraphSearch : public AStar
+	{
+		public:
+			using AStar::search;
+			/**
+			 *
+			 */
+			virtual Path search(Vertex aStart,
+								const Vertex& aGoal,
+								const Size& aRobotSize);
+			/**
+			 * A route from corner to corner costs less than the AStar routes the PathCache holds,
+			 * and a cached one would hide the corners from the robots of this planner
+			 */
+			virtual bool isCacheable() const
+			{
+				return false;
+			}
+	}; // class VisibilityGraphSearch
+} // namespace PathAlgorithm
+#endif // VISIBILITYGRAPH_HPP_
@@ -1,6 +1,7 @@
 #include "Wall.hpp"
 #include <sstream>
 #include "Logger.hpp"
+#include "RobotWorld.hpp"
 #include "Shape2DUtils.hpp"
 
 namespace Model
@@ -32,6 +33,7 @@ void Wall::setPoint1(const Point &aPoint1,
 					 bool aNotifyObservers /*= true*/)
 {
 	point1 = aPoint1;
+	RobotWorld::getRobotWorld().wallsChanged();
 	if (aNotifyObservers == true)
 	{
 		notifyObservers();
@@ -44,6 +46,7 @@ void Wall::setPoint2(const Point &aPoint2,
 					 bool aNotifyObservers /*= true*/)
 {
 	point2 = aPoint2;
+	RobotWorld::getRobotWorld().wallsChanged();
 	if (aNotifyObservers == true)
 	{
 		notifyObservers();